@@ -13,6 +13,7 @@
 #include "utils/random.hpp"
 #include "utils/general.hpp"
 #include "utils/timer.hpp"
+#include "utils/trace.hpp"
 #include "utils/ObjcHook.hpp"
 #include "utils/ZStringView.hpp"
 #include "utils/StringBuffer.hpp"
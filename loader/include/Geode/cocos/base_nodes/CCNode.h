@@ -42,6 +42,8 @@
 #include <Geode/utils/function.hpp>
 #include <Geode/utils/ZStringView.hpp>
 #include <Geode/ui/NodeEvent.hpp>
+#include <concepts>
+#include <type_traits>
 
 namespace geode {
     class Layout;
@@ -49,6 +51,11 @@ namespace geode {
     enum class Anchor;
 }
 
+namespace geode::utils::coro {
+    template <typename T> requires (std::copy_constructible<T> || std::is_reference_v<T>)
+    class Generator;
+}
+
 NS_CC_BEGIN
 
 class CCCamera;
@@ -913,8 +920,10 @@ public:
 
 private:
     friend class geode::modifier::FieldContainer;
+    friend class geode::modifier::FieldArena;
 
     GEODE_DLL geode::modifier::FieldContainer* getFieldContainer(char const* forClass);
+    GEODE_DLL geode::modifier::FieldArena* getFieldArena(size_t classIndex);
     GEODE_DLL geode::comm::ListenerHandle* addEventListenerInternal(
         std::string id,
         geode::comm::ListenerHandle handle
@@ -965,10 +974,45 @@ public:
      * equivalent to `getChildByIDRecursive("my-layer")
      * ->getChildByIDRecursive("button-menu")
      * ->getChildByID("mod.id/epic-button")`
+     * Each part of the query is searched breadth first from left to right,
+     * so the match is not necessarily the first one querySelectorAll yields
      * @returns The first matching node, or nullptr if none was found
      */
     GEODE_DLL CCNode* querySelector(std::string_view query);
 
+    /**
+     * Get every child matching a query, see querySelector for the supported
+     * syntax. Matches are found lazily as the result is iterated, so breaking
+     * out of the loop early skips searching the rest of the tree. Matches are
+     * yielded in depth first tree order, or in no particular order if this
+     * node or one of its ancestors has an ID index (see setIDIndexEnabled).
+     * querySelector searches breadth first instead, so the first match
+     * yielded is not necessarily the one it returns. Nodes must not be
+     * added or removed under this node while iterating
+     * @note Include Geode/utils/coro.hpp to iterate the result
+     * @returns A generator of the matching nodes
+     * @note Geode addition
+     */
+    GEODE_DLL geode::utils::coro::Generator<CCNode*> querySelectorAll(std::string_view query);
+
+    /**
+     * Keep an index of the IDs of every descendant of this node, so that
+     * getChildByIDRecursive and querySelector on this node or any of its
+     * descendants take time proportional to the number of matches instead
+     * of the size of the tree. The index is kept up to date as nodes are
+     * added, removed or get a new ID. Meant for large trees that are
+     * searched often, like the level editor
+     * @param enabled Whether the index should be kept
+     * @note Geode addition
+     */
+    GEODE_DLL void setIDIndexEnabled(bool enabled = true);
+
+    /**
+     * Whether this node keeps an index of the IDs of its descendants
+     * @note Geode addition
+     */
+    GEODE_DLL bool isIDIndexEnabled();
+
     /**
      * Removes a child from the container by its ID.
      * @param id The ID of the node
@@ -10,6 +10,9 @@
 #include <algorithm>
 #include <mutex>
 #include <atomic>
+#include <optional>
+#include <tuple>
+#include <utility>
 #include <asp/ptr/PtrSwap.hpp>
 #include <asp/iter.hpp>
 #include "../utils/function.hpp"
@@ -119,6 +122,10 @@ namespace geode::comm {
             other.m_sending = 0;
         }
 
+        void migrateFromV3(Port&& other) noexcept {
+            this->migrateFromV2(std::move(other));
+        }
+
         ReceiverHandle addReceiver(Callable receiver, int priority = 0) noexcept {
             ReceiverHandle handle = static_cast<ReceiverHandle>(m_nextID++);
             if (m_sending > 0) {
@@ -126,34 +133,46 @@ namespace geode::comm {
                 m_toAdd.push_back({std::move(receiver), priority, handle});
                 return handle;
             }
-            for (auto it = m_receivers.begin(); it != m_receivers.end(); ++it) {
-                if (priority < it->m_priority) {
-                    // geode::console::log(fmt::format("Added handler with id {} to receivers", handle), Severity::Debug);
-                    m_receivers.insert(it, {std::move(receiver), priority, handle});
-                    return handle;
-                }
-            }
-            m_receivers.push_back({std::move(receiver), priority, handle});
+            // geode::console::log(fmt::format("Added handler with id {} to receivers", handle), Severity::Debug);
+            // insert after every receiver with the same priority to keep insertion order
+            m_receivers.insert(std::upper_bound(m_receivers.begin(), m_receivers.end(), priority, [](int priority, auto& it) {
+                return priority < it.m_priority;
+            }), {std::move(receiver), priority, handle});
             return handle;
         }
 
         size_t removeReceiver(ReceiverHandle handle) noexcept {
-            auto size = m_receivers.size();
-            for (int i = 0; i < size; ++i) {
-                if (m_receivers[i].m_handle == handle) {
-                    if (m_sending > 0) {
-                        // geode::console::log(fmt::format("Added handler with id {} to toRemove", handle), Severity::Debug);
-                        m_toRemove.push_back(m_receivers.begin() + i);
-                    } else {
-                        // geode::console::log(fmt::format("Removed handler with id {} from receivers", handle), Severity::Debug);
-                        m_receivers.erase(m_receivers.begin() + i);
-                    }
-                    // size - 1, return for symmetry
-                    return size - 1;
-                }
+            // 0 is never handed out and marks removed receivers, which must not match
+            if (handle == ReceiverHandle()) {
+                return this->getReceiverCount();
+            }
+            auto pending = std::find_if(m_toAdd.begin(), m_toAdd.end(), [handle](auto& it) {
+                return it.m_handle == handle;
+            });
+            if (pending != m_toAdd.end()) {
+                // never got to be a receiver, so it can go right away
+                m_toAdd.erase(pending);
+                return this->getReceiverCount();
             }
-            // size
-            return size;
+            auto it = std::find_if(m_receivers.begin(), m_receivers.end(), [handle](auto& it) {
+                return it.m_handle == handle;
+            });
+            if (it == m_receivers.end()) {
+                // size
+                return this->getReceiverCount();
+            }
+            if (m_sending > 0) {
+                // geode::console::log(fmt::format("Tombstoned handler with id {}", handle), Severity::Debug);
+                // Handles start from 1, so 0 marks a receiver as removed. The callable
+                // itself has to stay alive since it might be the one that is running.
+                it->m_handle = ReceiverHandle();
+                m_toRemove.push_back(it);
+            } else {
+                // geode::console::log(fmt::format("Removed handler with id {} from receivers", handle), Severity::Debug);
+                m_receivers.erase(it);
+            }
+            // size - 1, return for symmetry
+            return this->getReceiverCount();
         }
 
         size_t getReceiverCount() const noexcept {
@@ -165,11 +184,16 @@ namespace geode::comm {
         bool send(Args&&... value) noexcept(std::is_nothrow_invocable_v<Callable, Args...>) {
             m_sending++;
             bool ret = false;
+            // m_receivers can not reallocate while sending, adds are deferred to m_toAdd
             for (auto& callable : m_receivers) {
-                if (std::find_if(m_toRemove.begin(), m_toRemove.end(), [&callable](auto& it) {
-                    return it->m_handle == callable.m_handle;
+                if (callable.m_handle == ReceiverHandle()) {
+                    // geode::console::log("Skipping tombstoned handler", Severity::Debug);
+                    continue;
+                }
+                // code from older headers removes without tombstoning
+                if (!m_toRemove.empty() && std::find_if(m_toRemove.begin(), m_toRemove.end(), [&callable](auto& it) {
+                    return &*it == &callable;
                 }) != m_toRemove.end()) {
-                    // geode::console::log(fmt::format("Skipping handler with id {} because it is in toRemove", callable.m_handle), Severity::Debug);
                     continue;
                 }
                 if (callable.call(value...)) {
@@ -180,245 +204,368 @@ namespace geode::comm {
             m_sending--;
 
             if (m_sending == 0) {
-                // geode::console::log(fmt::format("Flushing {} handlers from toRemove", m_toRemove.size()), Severity::Debug);
-                std::sort(m_toRemove.rbegin(), m_toRemove.rend());
+                this->flushPending();
+            }
+
+            return ret;
+        }
+
+    private:
+        void flushPending() noexcept {
+            if (!m_toRemove.empty()) {
+                // geode::console::log(fmt::format("Flushing {} tombstoned handlers", m_toRemove.size()), Severity::Debug);
+                // code from older headers only queues the removal, tombstone those too
                 for (auto& it : m_toRemove) {
-                    m_receivers.erase(it);
+                    it->m_handle = ReceiverHandle();
                 }
+                std::erase_if(m_receivers, [](auto& it) {
+                    return it.m_handle == ReceiverHandle();
+                });
                 m_toRemove.clear();
+            }
 
-                // geode::console::log(fmt::format("Flushing {} handlers from toAdd", m_toAdd.size()), Severity::Debug);
-                m_receivers.insert(m_receivers.end(), std::make_move_iterator(m_toAdd.begin()), std::make_move_iterator(m_toAdd.end()));
-                m_toAdd.clear();
-                std::sort(m_receivers.begin(), m_receivers.end(), [](auto& a, auto& b) {
+            if (!m_toAdd.empty()) {
+                // geode::console::log(fmt::format("Merging {} handlers from toAdd", m_toAdd.size()), Severity::Debug);
+                std::stable_sort(m_toAdd.begin(), m_toAdd.end(), [](auto& a, auto& b) {
                     return a.m_priority < b.m_priority;
                 });
-            }
 
-            return ret;
+                // merge from the back so that nothing has to be moved twice, pending
+                // receivers go after existing ones of the same priority
+                auto receiverIdx = m_receivers.size();
+                auto addIdx = m_toAdd.size();
+                m_receivers.resize(receiverIdx + addIdx);
+                auto outIdx = m_receivers.size();
+                while (addIdx > 0) {
+                    if (receiverIdx > 0 && m_toAdd[addIdx - 1].m_priority < m_receivers[receiverIdx - 1].m_priority) {
+                        m_receivers[--outIdx] = std::move(m_receivers[--receiverIdx]);
+                    } else {
+                        m_receivers[--outIdx] = std::move(m_toAdd[--addIdx]);
+                    }
+                }
+                m_toAdd.clear();
+            }
         }
     };
 
     template <class Callable, template <class> class Container>
     class Port<Callable, true, Container>  {
         using VectorType = std::vector<Container<Callable>>;
-        // we should have just used a atomic shared ptr!
+        // Up to V3 these were the only members, and mods built with older headers
+        // still run their inline V3 code on ports created by newer ones, which
+        // modifies *m_receivers in place under m_mutex. They are kept up to date
+        // for that code, but since V4 nothing iterates them outside of the lock.
         asp::PtrSwap<VectorType> m_receivers;
         mutable std::mutex m_mutex;
         std::vector<typename std::vector<Container<Callable>>::iterator> m_toRemove;
         std::vector<Container<Callable>> m_toAdd;
         size_t m_nextID = 1;
         size_t m_sending = 0;
+        // V4: bumped on every removal, so that a send that is still iterating an
+        // older snapshot knows it has to check whether a receiver is still alive
+        std::atomic_size_t m_removals = 0;
+        // V4: the receivers as immutable snapshots. Senders only load the current
+        // one and iterate it without holding any lock, writers build a new one
+        // from the members above under m_mutex and publish it.
+        asp::PtrSwap<VectorType> m_snapshot;
+        // V4: what the snapshot was built from, to notice changes made by V3 code
+        size_t m_snapshotNextID = 1;
+        size_t m_snapshotCount = 0;
+
+        bool isReceiverAlive(ReceiverHandle handle) const noexcept {
+            auto receivers = m_snapshot.load();
+            return std::find_if(receivers->begin(), receivers->end(), [handle](auto& it) {
+                return it.m_handle == handle;
+            }) != receivers->end();
+        }
+
+        bool isPendingRemoval(ReceiverHandle handle) const noexcept {
+            return std::find_if(m_toRemove.begin(), m_toRemove.end(), [handle](auto& it) {
+                return it->m_handle == handle;
+            }) != m_toRemove.end();
+        }
+
+        size_t getLegacyCount() const noexcept {
+            return m_receivers.load()->size() + m_toAdd.size() - m_toRemove.size();
+        }
+
+        // The receivers once every pending change is applied. Only reads the V3
+        // members, so it's safe to call on ports made by older headers.
+        // Has to be called with m_mutex held
+        VectorType collect() const noexcept {
+            VectorType receivers;
+            receivers.reserve(this->getLegacyCount());
+            for (auto& receiver : *m_receivers.load()) {
+                if (!this->isPendingRemoval(receiver.m_handle)) {
+                    receivers.push_back(receiver);
+                }
+            }
+            for (auto& receiver : m_toAdd) {
+                receivers.insert(std::upper_bound(receivers.begin(), receivers.end(), receiver.m_priority, [](int priority, auto& it) {
+                    return priority < it.m_priority;
+                }), receiver);
+            }
+            return receivers;
+        }
+
+        // Has to be called with m_mutex held
+        void publish() noexcept {
+            auto receivers = asp::make_shared<VectorType>(this->collect());
+            m_snapshotNextID = m_nextID;
+            m_snapshotCount = receivers->size();
+            m_snapshot.store(std::move(receivers));
+        }
+
+        // Has to be called with m_mutex held
+        void adopt(VectorType receivers, size_t nextID) noexcept {
+            // ports older than V3 don't carry the next ID over
+            for (auto& receiver : receivers) {
+                nextID = std::max(nextID, receiver.m_handle + 1);
+            }
+            m_receivers.store(asp::make_shared<VectorType>(std::move(receivers)));
+            m_nextID = nextID;
+            this->publish();
+        }
     public:
         using CallableType = Callable;
         using EventCenterType = EventCenterGlobal;
 
-        Port() : m_receivers(asp::make_shared<VectorType>()) {}
+        Port() : m_receivers(asp::make_shared<VectorType>()), m_snapshot(asp::make_shared<VectorType>()) {}
 
         void migrateFromV1(Port&& other) noexcept {
-            m_receivers.store(other.m_receivers.load());
+            auto lock = std::unique_lock<std::mutex>(m_mutex);
+            this->adopt(*other.m_receivers.load(), m_nextID);
         }
 
         void migrateFromV2(Port&& other) noexcept {
-            m_receivers.store(other.m_receivers.load());
+            auto lock = std::unique_lock<std::mutex>(m_mutex);
+            this->adopt(*other.m_receivers.load(), m_nextID);
+        }
+
+        void migrateFromV3(Port&& other) noexcept {
+            auto lock = std::unique_lock<std::mutex>(m_mutex);
+            auto otherLock = std::unique_lock<std::mutex>(other.m_mutex);
+            // V3 senders could still have had pending changes, apply them to the new port
+            this->adopt(other.collect(), other.m_nextID);
+        }
+
+        // Picks up receivers that were added or removed by V3 code since the last
+        // snapshot. Every add and remove goes through EventCenterGlobal, which
+        // calls this afterwards, see LegacyPortSync
+        void syncLegacy() noexcept {
+            auto lock = std::unique_lock<std::mutex>(m_mutex);
+            if (m_nextID == m_snapshotNextID && this->getLegacyCount() == m_snapshotCount) {
+                return;
+            }
+            this->publish();
+            m_removals.fetch_add(1, std::memory_order_release);
         }
 
         ReceiverHandle addReceiver(Callable receiver, int priority = 0) noexcept {
             auto lock = std::unique_lock<std::mutex>(m_mutex);
             ReceiverHandle handle = static_cast<ReceiverHandle>(m_nextID++);
-            auto receivers = m_receivers.load();
             if (m_sending > 0) {
-                // geode::console::log(fmt::format("Added handler with id {} to toAdd", handle), Severity::Debug);
+                // a V3 send is iterating m_receivers, it merges these in when it's done
                 m_toAdd.push_back({std::move(receiver), priority, handle});
-                return handle;
             }
-            for (auto it = receivers->begin(); it != receivers->end(); ++it) {
-                if (priority < it->m_priority) {
-                    // geode::console::log(fmt::format("Added handler with id {} to receivers", handle), Severity::Debug);
-                    receivers->insert(it, {std::move(receiver), priority, handle});
-                    return handle;
-                }
+            else {
+                // insert after every receiver with the same priority to keep insertion order
+                auto receivers = m_receivers.load();
+                receivers->insert(std::upper_bound(receivers->begin(), receivers->end(), priority, [](int priority, auto& it) {
+                    return priority < it.m_priority;
+                }), {std::move(receiver), priority, handle});
             }
-            receivers->push_back({std::move(receiver), priority, handle});
+            this->publish();
             return handle;
         }
 
         size_t removeReceiver(ReceiverHandle handle) noexcept {
             auto lock = std::unique_lock<std::mutex>(m_mutex);
-            auto receivers = m_receivers.load();
-            auto size = receivers->size();
-            for (int i = 0; i < size; ++i) {
-                if ((*receivers)[i].m_handle == handle) {
-                    if (m_sending > 0) {
-                        // geode::console::log(fmt::format("Added handler with id {} to toRemove", handle), Severity::Debug);
-                        m_toRemove.push_back(receivers->begin() + i);
-                    } else {
-                        // geode::console::log(fmt::format("Removed handler with id {} from receivers", handle), Severity::Debug);
-                        receivers->erase(receivers->begin() + i);
-                    }
-                    // size - 1, return for symmetry
-                    return size - 1;
+            auto pending = std::find_if(m_toAdd.begin(), m_toAdd.end(), [handle](auto& it) {
+                return it.m_handle == handle;
+            });
+            if (pending != m_toAdd.end()) {
+                m_toAdd.erase(pending);
+            }
+            else {
+                auto receivers = m_receivers.load();
+                auto it = std::find_if(receivers->begin(), receivers->end(), [handle](auto& it) {
+                    return it.m_handle == handle;
+                });
+                if (it == receivers->end() || this->isPendingRemoval(handle)) {
+                    // size
+                    return m_snapshotCount;
+                }
+                if (m_sending > 0) {
+                    // same as V3, the send that is running erases it when it's done
+                    m_toRemove.push_back(it);
+                }
+                else {
+                    receivers->erase(it);
                 }
             }
-            // size
-            return size;
+            this->publish();
+            m_removals.fetch_add(1, std::memory_order_release);
+            // size - 1, return for symmetry
+            return m_snapshotCount;
         }
 
         size_t getReceiverCount() const noexcept {
-            auto lock = std::unique_lock<std::mutex>(m_mutex);
-            return m_receivers.load()->size() + m_toAdd.size() - m_toRemove.size();
+            return m_snapshot.load()->size();
         }
 
         template <class ...Args>
         requires std::invocable<Callable, Args...>
         bool send(Args&&... value) noexcept(std::is_nothrow_invocable_v<Callable, Args...>) {
-            auto lock = std::unique_lock<std::mutex>(m_mutex);
-
-            m_sending++;
-            bool ret = false;
-            auto receivers = m_receivers.load();
+            auto removals = m_removals.load(std::memory_order_acquire);
+            // the snapshot keeps every receiver alive until we are done with it,
+            // even if it gets removed by another thread in the meantime
+            auto receivers = m_snapshot.load();
             for (auto& callable : *receivers) {
-                if (std::find_if(m_toRemove.begin(), m_toRemove.end(), [&callable](auto& it) {
-                    return it->m_handle == callable.m_handle;
-                }) != m_toRemove.end()) {
-                    // geode::console::log(fmt::format("Skipping handler with id {} because it is in toRemove", callable.m_handle), Severity::Debug);
+                if (m_removals.load(std::memory_order_acquire) != removals && !this->isReceiverAlive(callable.m_handle)) {
+                    // geode::console::log(fmt::format("Skipping handler with id {} because it was removed", callable.m_handle), Severity::Debug);
                     continue;
                 }
-                lock.unlock();
                 if (callable.call(value...)) {
-                    ret = true;
-                    lock.lock();
-                    break;
+                    return true;
                 }
-                lock.lock();
             }
-            m_sending--;
+            return false;
+        }
+    };
 
-            if (m_sending == 0) {
-                auto receivers = m_receivers.load();
-                std::sort(m_toRemove.rbegin(), m_toRemove.rend());
-                for (auto& it : m_toRemove) {
-                    receivers->erase(it);
-                }
-                m_toRemove.clear();
+    // Implemented by ports that have to notice changes made to them by the
+    // inline code of mods built with older headers
+    class LegacyPortSync {
+    public:
+        virtual ~LegacyPortSync() noexcept = default;
+        virtual void syncLegacy() noexcept = 0;
+    };
 
-                receivers->insert(receivers->end(), std::make_move_iterator(m_toAdd.begin()), std::make_move_iterator(m_toAdd.end()));
-                m_toAdd.clear();
-                std::sort(receivers->begin(), receivers->end(), [](auto& a, auto& b) {
-                    return a.m_priority < b.m_priority;
-                });
+    template <class Callable>
+    struct PortPayload;
+
+    template <template <class> class Function, class Return, class... Args>
+    struct PortPayload<Function<Return(Args...)>> {
+        using type = std::tuple<std::decay_t<Args>...>;
+    };
+
+    // A copy of the arguments of a send, for ports that have to hold onto them
+    template <class Callable>
+    using PortPayloadType = typename PortPayload<Callable>::type;
+
+    struct NoMutex {
+        void lock() noexcept {}
+        void unlock() noexcept {}
+    };
+
+    // Latches the first send, every later send is ignored. Listeners that are
+    // added after the send get called with its payload right away, see
+    // BasicEvent::addReceiver.
+    template <class Callable, bool ThreadSafe = false, template <class> class Container = PortCallableCopy>
+    class OncePort : public Port<Callable, ThreadSafe, Container> {
+        using Base = Port<Callable, ThreadSafe, Container>;
+        using PayloadType = PortPayloadType<Callable>;
+
+        // recursive so that receivers can add listeners while the payload is being sent
+        mutable std::conditional_t<ThreadSafe, std::recursive_mutex, NoMutex> m_latchMutex;
+        std::optional<PayloadType> m_payload;
+        std::vector<ReceiverHandle> m_late;
+
+    public:
+        ReceiverHandle addReceiver(Callable receiver, int priority = 0) noexcept {
+            auto lock = std::unique_lock(m_latchMutex);
+            auto handle = Base::addReceiver(std::move(receiver), priority);
+            if (m_payload) {
+                m_late.push_back(handle);
             }
+            return handle;
+        }
 
-            return ret;
+        size_t removeReceiver(ReceiverHandle handle) noexcept {
+            auto lock = std::unique_lock(m_latchMutex);
+            std::erase(m_late, handle);
+            auto size = Base::removeReceiver(handle);
+            // a sent port counts as a receiver so the event center keeps the payload around
+            return m_payload ? size + 1 : size;
+        }
+
+        template <class ...Args>
+        requires std::invocable<Callable, Args...>
+        bool send(Args&&... args) noexcept(std::is_nothrow_invocable_v<Callable, Args...>) {
+            auto lock = std::unique_lock(m_latchMutex);
+            if (m_payload) return false;
+            m_payload.emplace(args...);
+            return Base::send(std::forward<Args>(args)...);
+        }
+
+        // Returns the payload if the receiver was added after the send and has not been called yet
+        std::optional<PayloadType> takeLate(ReceiverHandle handle) noexcept {
+            auto lock = std::unique_lock(m_latchMutex);
+            if (std::erase(m_late, handle) == 0) return std::nullopt;
+            return m_payload;
+        }
+
+        bool isSent() const noexcept {
+            auto lock = std::unique_lock(m_latchMutex);
+            return m_payload.has_value();
+        }
+    };
+
+    // Buffers sends until they are flushed in one batch, see BasicEvent::send
+    // for when that happens. With Coalesce, only the latest payload is kept.
+    template <class Callable, bool ThreadSafe, template <class> class Container, bool Coalesce>
+    class BasicQueuedPort : public Port<Callable, ThreadSafe, Container> {
+        using Base = Port<Callable, ThreadSafe, Container>;
+        using PayloadType = PortPayloadType<Callable>;
+
+        mutable std::conditional_t<ThreadSafe, std::mutex, NoMutex> m_queueMutex;
+        std::vector<PayloadType> m_queue;
+        bool m_flushScheduled = false;
+
+    public:
+        // Returns true if there was no flush scheduled yet, the caller has to schedule one
+        template <class ...Args>
+        requires std::invocable<Callable, Args...>
+        bool enqueue(Args&&... args) noexcept {
+            auto lock = std::unique_lock(m_queueMutex);
+            if constexpr (Coalesce) {
+                m_queue.clear();
+            }
+            m_queue.emplace_back(std::forward<Args>(args)...);
+            return !std::exchange(m_flushScheduled, true);
+        }
+
+        void flush() noexcept(std::is_nothrow_invocable_v<Callable, PayloadType&>) {
+            std::vector<PayloadType> batch;
+            {
+                auto lock = std::unique_lock(m_queueMutex);
+                batch.swap(m_queue);
+                m_flushScheduled = false;
+            }
+            for (auto& payload : batch) {
+                std::apply([this](auto&... args) {
+                    Base::send(args...);
+                }, payload);
+            }
         }
     };
 
-    // template <class Callable, bool ThreadSafe = false>
-    // class OncePort : protected Port<Callable, ThreadSafe, PortCallableMove> {
-    //     std::conditional_t<ThreadSafe, std::atomic_flag, bool> m_sent = false;
-    // public:
-    //     using CallableType = Callable;
-
-    //     using Port<Callable, ThreadSafe>::addReceiver;
-    //     using Port<Callable, ThreadSafe>::removeReceiver;
-
-    //     template <class ...Args>
-    //     bool send(Args&&... args) noexcept(std::is_nothrow_invocable_v<Callable, Args...>) {
-
-    //         if constexpr (ThreadSafe) {
-    //             if (m_sent.test_and_set())
-    //                 return false;
-    //         } else {
-    //             if (m_sent) return false;
-    //             m_sent = true;
-    //         }
-
-    //         return Port<Callable, ThreadSafe>::send(std::forward<Args>(args)...);
-    //     }
-    //     bool isSent() const noexcept {
-    //         if constexpr (ThreadSafe)
-    //             return m_sent.test();
-    //         else
-    //             return m_sent;
-    //     }
-    // };
-
-    // template <class Callable, bool ThreadSafe = false, template <class> class Container = PortCallableCopy>
-    // class QueuedPort : protected Port<Callable, ThreadSafe, Container> {
-    //     using VectorType = std::vector<geode::CopyableFunction<void()>>;
-    //     std::conditional_t<ThreadSafe, asp::PtrSwap<VectorType>, VectorType> m_queue;
-    // public:
-    //     using CallableType = Callable;
-
-    //     using Port<Callable, ThreadSafe>::addReceiver;
-    //     using Port<Callable, ThreadSafe>::removeReceiver;
-
-    //     template <class ...Args>
-    //     requires std::invocable<Callable, Args...>
-    //     bool send(Args&&... args) noexcept(std::is_nothrow_invocable_v<Callable, Args...>) {
-    //         auto lam = [=, this] {
-    //             return Port<Callable, ThreadSafe>::send(args...);
-    //         };
-
-    //         if constexpr (ThreadSafe) {
-    //             m_queue.rcu([&](auto const& ptr) {
-    //                 auto newQueue = asp::make_shared<VectorType>(*ptr.get());
-    //                 newQueue->push_back(lam);
-    //                 return newQueue;
-    //             });
-    //         } else {
-    //             m_queue.push_back(lam);
-    //         }
-    //         return false;
-    //     }
-
-    //     void flush() noexcept {
-    //         if constexpr (ThreadSafe) {
-    //             m_queue.rcu([&](auto const& ptr) {
-    //                 auto newQueue = asp::make_shared<VectorType>(*ptr.get());
-    //                 for (auto& q : *newQueue) {
-    //                     std::invoke(q);
-    //                 }
-    //                 newQueue->clear();
-    //                 return newQueue;
-    //             });
-    //         } else {
-    //             for (auto& q : m_queue) {
-    //                 std::invoke(q);
-    //             }
-    //             m_queue.clear();
-    //         }
-    //     }
-    // };
-
-    // template <class Callable, bool ThreadSafe = false>
-    // class QueuedOncePort : protected QueuedPort<Callable, ThreadSafe, PortCallableMove> {
-    //     std::conditional_t<ThreadSafe, std::atomic_flag, bool> m_sent = false;
-    // public:
-    //     using CallableType = Callable;
-
-    //     using QueuedPort<Callable, ThreadSafe>::addReceiver;
-    //     using QueuedPort<Callable, ThreadSafe>::removeReceiver;
-    //     using QueuedPort<Callable, ThreadSafe>::flush;
-
-    //     template <class ...Args>
-    //     bool send(Args&&... args) noexcept(std::is_nothrow_invocable_v<Callable, Args...>) {
-    //         if constexpr (ThreadSafe) {
-    //             if (m_sent.test_and_set())
-    //                 return false;
-    //         } else {
-    //             if (m_sent) return false;
-    //             m_sent = true;
-    //         }
-    //         return QueuedPort<Callable, ThreadSafe>::send(std::forward<Args>(args)...);
-    //     }
-    //     bool isSent() const noexcept {
-    //         if constexpr (ThreadSafe)
-    //             return m_sent.test();
-    //         else
-    //             return m_sent;
-    //     }
-    // };
+    template <class Callable, bool ThreadSafe = false, template <class> class Container = PortCallableCopy>
+    using QueuedPort = BasicQueuedPort<Callable, ThreadSafe, Container, false>;
+
+    template <class Callable, bool ThreadSafe = false, template <class> class Container = PortCallableCopy>
+    using CoalescedPort = BasicQueuedPort<Callable, ThreadSafe, Container, true>;
+
+    template <class Port>
+    concept IsOncePort = requires(Port p, ReceiverHandle h) {
+        { p.takeLate(h) };
+    };
+
+    template <class Port>
+    concept IsQueuedPort = requires(Port p) {
+        { p.flush() };
+    };
 
     template <template <class, bool, template <class> class> class PortType, bool ThreadSafe, template <class> class Container>
     struct PortWrapper {
@@ -427,6 +574,8 @@ namespace geode::comm {
     };
 
     static_assert(PortTemplateFor<PortWrapper<Port, true, PortCallableCopy>::type, geode::CopyableFunction<void()>>, "Port type is not a valid port");
+    static_assert(PortTemplateFor<PortWrapper<OncePort, true, PortCallableCopy>::type, geode::CopyableFunction<void()>>, "Port type is not a valid port");
+    static_assert(PortTemplateFor<PortWrapper<QueuedPort, true, PortCallableCopy>::type, geode::CopyableFunction<void()>>, "Port type is not a valid port");
 
     class EventCenter;
 
@@ -443,6 +592,10 @@ namespace geode::comm {
     requires PortTemplateFor<PortTemplate, geode::CopyableFunction<bool(PArgs...)>>
     class OpaqueEventPortV3;
 
+    template <template <class> class PortTemplate, class... PArgs>
+    requires PortTemplateFor<PortTemplate, geode::CopyableFunction<bool(PArgs...)>>
+    class OpaqueEventPortV4;
+
     // In order to version Ports, we need to make a new EventPort class for every version,
     // and subclass the previous one. For example a V3 would subclass V2, which subclasses V1.
     // This is because we dont have a virtual version check function (i forgot) wait actually
@@ -478,8 +631,25 @@ namespace geode::comm {
             return m_port.removeReceiver(handle);
         }
 
+        template <class... Args>
+        bool enqueue(Args&&... args) noexcept
+        requires IsQueuedPort<PortTemplate<geode::CopyableFunction<bool(PArgs...)>>> {
+            return m_port.enqueue(std::forward<Args>(args)...);
+        }
+
+        void flush() noexcept
+        requires IsQueuedPort<PortTemplate<geode::CopyableFunction<bool(PArgs...)>>> {
+            m_port.flush();
+        }
+
+        auto takeLate(ReceiverHandle handle) noexcept
+        requires IsOncePort<PortTemplate<geode::CopyableFunction<bool(PArgs...)>>> {
+            return m_port.takeLate(handle);
+        }
+
         friend class OpaqueEventPortV2<PortTemplate, PArgs...>;
         friend class OpaqueEventPortV3<PortTemplate, PArgs...>;
+        friend class OpaqueEventPortV4<PortTemplate, PArgs...>;
     };
 
     template <template <class> class PortTemplate, class... PArgs>
@@ -506,6 +676,27 @@ namespace geode::comm {
         }
     };
 
+    // V4 appends the removal counter and the snapshot to the thread safe port.
+    // Older code still uses V4 ports as V3 ones, so they also have to keep the
+    // V3 members working, see Port<Callable, true, Container>
+    template <template <class> class PortTemplate, class... PArgs>
+    requires PortTemplateFor<PortTemplate, geode::CopyableFunction<bool(PArgs...)>>
+    class OpaqueEventPortV4 : public OpaqueEventPortV3<PortTemplate, PArgs...>, public LegacyPortSync {
+    public:
+        OpaqueEventPortV4() {}
+        ~OpaqueEventPortV4() noexcept override {}
+
+        void migrateFromV3(OpaqueEventPortV3<PortTemplate, PArgs...>* oldPort) noexcept {
+            this->m_port.migrateFromV3(std::move(oldPort->m_port));
+        }
+
+        void syncLegacy() noexcept override {
+            if constexpr (requires { this->m_port.syncLegacy(); }) {
+                this->m_port.syncLegacy();
+            }
+        }
+    };
+
     class BaseFilter {
     public:
         virtual ~BaseFilter() noexcept = default;
@@ -639,28 +830,38 @@ namespace geode::comm {
         using OpaqueEventType = OpaqueEventPort<PortTemplate, PArgs...>;
         using OpaqueEventV2Type = OpaqueEventPortV2<PortTemplate, PArgs...>;
         using OpaqueEventV3Type = OpaqueEventPortV3<PortTemplate, PArgs...>;
-        using LatestOpaqueEventType = OpaqueEventV3Type;
+        using OpaqueEventV4Type = OpaqueEventPortV4<PortTemplate, PArgs...>;
+        using LatestOpaqueEventType = OpaqueEventV4Type;
         using EventCenterType = LatestOpaqueEventType::EventCenterType;
+        using PortType = PortTemplate<geode::CopyableFunction<bool(PArgs...)>>;
 
         // Here we migrate the port version if needed. This is what I meant by versioning,
         // we need to check for previous versions and move them into the current version.
         // Go to getPort definition.
         static OpaquePortBase* migratePort(OpaquePortBase* port) {
-            // handles V1->V3
+            // handles V1->V4
             if (!geode::cast::typeinfo_cast<OpaqueEventV2Type*>(port)) {
                 auto oldPort = static_cast<OpaqueEventType*>(port);
-                auto newPort = new OpaqueEventV3Type();
+                auto newPort = new OpaqueEventV4Type();
                 newPort->migrateFromV1(oldPort);
                 return newPort;
             }
 
-            // handles V2->V3
+            // handles V2->V4
             if (!geode::cast::typeinfo_cast<OpaqueEventV3Type*>(port)) {
                 auto oldPort = static_cast<OpaqueEventV2Type*>(port);
-                auto newPort = new OpaqueEventV3Type();
+                auto newPort = new OpaqueEventV4Type();
                 newPort->migrateFromV2(oldPort);
                 return newPort;
             }
+
+            // handles V3->V4
+            if (!geode::cast::typeinfo_cast<OpaqueEventV4Type*>(port)) {
+                auto oldPort = static_cast<OpaqueEventV3Type*>(port);
+                auto newPort = new OpaqueEventV4Type();
+                newPort->migrateFromV3(oldPort);
+                return newPort;
+            }
             return nullptr;
         }
 
@@ -688,7 +889,7 @@ namespace geode::comm {
         // All of the normal functions do static cast version, but that is not strictly needed,
         // what is needed however is updating this getPort function.
         OpaquePortBase* getPort() const noexcept override {
-            return new (std::nothrow) OpaqueEventV3Type();
+            return new (std::nothrow) OpaqueEventV4Type();
         }
 
         size_t hash() const noexcept override {
@@ -723,10 +924,48 @@ namespace geode::comm {
             // geode::console::log(fmt::format("Destroying BasicEvent {}, {}", (void*)this, typeid(Marker).name()), Severity::Debug);
         }
 
+        /// Sends the event to every receiver. For queued and coalesced events the
+        /// arguments are copied and delivered later in one batch, on the main thread
+        /// at the start of the next frame, or the next time the sending thread
+        /// processes its posted functions if it has its own event center and the
+        /// event is not thread safe. Those sends always return false.
         bool send(PArgs... args) noexcept(std::is_nothrow_invocable_v<geode::CopyableFunction<PReturn(PArgs...)>, PArgs...>);
 
         size_t getReceiverCount() const noexcept;
 
+        /// A pre-resolved handle to the port of a specific filter. Sending through
+        /// a channel skips hashing the filter and looking it up in the event center,
+        /// the port is only resolved again after the event center has added, erased
+        /// or migrated a port. Channels are not thread safe, use one per thread.
+        class Channel {
+        private:
+            Self m_event;
+            EventCenterType* m_center = nullptr;
+            size_t m_generation = 0;
+            std::shared_ptr<OpaquePortBase> m_port;
+
+        public:
+            Channel(Self const& event) noexcept : m_event(CloneMarker{}, event.m_filter) {}
+
+            bool send(PArgs... args) noexcept(std::is_nothrow_invocable_v<geode::CopyableFunction<PReturn(PArgs...)>, PArgs...>);
+        };
+
+        Channel channel() const noexcept {
+            return Channel(*this);
+        }
+
+        // Send this event on another thread, into the ports of that thread's event
+        // center. The arguments are copied. See EventCenterThreadLocal::postTo.
+        bool postTo(std::thread::id thread, PArgs... args) const noexcept;
+        void postToMain(PArgs... args) const noexcept;
+
+        // The dynamic type of the filters that the event centers store
+        using FilterType = Self;
+
+        std::tuple<FArgs...> const& getFilter() const noexcept {
+            return m_filter;
+        }
+
         template<class Callable>
         ListenerHandle listen(Callable listener, int priority = 0) const noexcept {
             if constexpr (std::is_convertible_v<std::invoke_result_t<Callable, PArgs...>, bool>) {
@@ -747,6 +986,18 @@ namespace geode::comm {
         }
     };
 
+    struct ResolvedPort {
+        std::shared_ptr<OpaquePortBase> port;
+        size_t generation = 0;
+    };
+
+    // Non thread safe events go through one EventCenterThreadLocal that belongs
+    // to the main thread, which processes posted functions for it. Any other
+    // thread that uses those events must first get a center of its own with
+    // useOwnForCurrentThread, so its ports are never shared with other threads;
+    // its listeners then only receive events sent on that thread. A thread that
+    // doesn't races with the main thread on its center, and logs an error once.
+    // Use postTo/postToMain to send an event on another thread.
     class GEODE_DLL EventCenterThreadLocal {
     private:
         class Impl;
@@ -758,6 +1009,25 @@ namespace geode::comm {
     public:
         static EventCenterThreadLocal* get();
 
+        // Gives the current thread its own event center from now on, which is
+        // destroyed when the thread exits. The thread must call processPosted
+        // on it from its own loop.
+        static void useOwnForCurrentThread();
+        // Whether something calls processPosted for the current thread's center
+        // on this thread, which is the main thread and threads with their own center
+        static bool isProcessedOnCurrentThread() noexcept;
+
+        using PostFuncType = geode::Function<void()>;
+
+        // Queues a function to run on the given thread the next time processPosted is
+        // called there. Returns false if the thread has no event center (yet, or anymore).
+        static bool postTo(std::thread::id thread, PostFuncType func) noexcept;
+        static void postToMain(PostFuncType func) noexcept;
+
+        // Runs every function posted to this event center so far. The main thread
+        // does this every frame, other threads should call it from their own loop.
+        void processPosted() noexcept;
+
         using SendFuncType = geode::Function<bool(OpaquePortBase*)>;
         using AddFuncType = geode::Function<ReceiverHandle(OpaquePortBase*)>;
         using SizeFuncType = geode::Function<size_t(OpaquePortBase*)>;
@@ -768,6 +1038,10 @@ namespace geode::comm {
         ListenerHandle addReceiver(BaseFilter const* filter, AddFuncType func, MigrateFuncType migratePort) noexcept;
         size_t getReceiverCount(BaseFilter const* filter, SizeFuncType func, MigrateFuncType migratePort) noexcept;
         size_t removeReceiver(BaseFilter const* filter, RemoveFuncType func, MigrateFuncType migratePort) noexcept;
+
+        // Bumped every time a port is added, erased or migrated
+        size_t getGeneration() const noexcept;
+        ResolvedPort resolvePort(BaseFilter const* filter, MigrateFuncType migratePort) noexcept;
     };
 
     class GEODE_DLL EventCenterGlobal {
@@ -791,6 +1065,10 @@ namespace geode::comm {
         ListenerHandle addReceiver(BaseFilter const* filter, AddFuncType func, MigrateFuncType migratePort) noexcept;
         size_t getReceiverCount(BaseFilter const* filter, SizeFuncType func, MigrateFuncType migratePort) noexcept;
         size_t removeReceiver(BaseFilter const* filter, RemoveFuncType func, MigrateFuncType migratePort) noexcept;
+
+        // Bumped every time a port is added, erased or migrated
+        size_t getGeneration() const noexcept;
+        ResolvedPort resolvePort(BaseFilter const* filter, MigrateFuncType migratePort) noexcept;
     };
 
     class EventCenter {
@@ -803,6 +1081,10 @@ namespace geode::comm {
     public:
         GEODE_DLL static EventCenter* get();
 
+        bool isEmpty() noexcept {
+            return m_ports.load()->empty();
+        }
+
         template <class Callable, class Callable2>
         requires std::is_invocable_v<Callable, OpaquePortBase*>
         bool send(BaseFilter const* filter, Callable func, Callable2 migratePort) noexcept(std::is_nothrow_invocable_v<Callable, OpaquePortBase*>) {
@@ -902,6 +1184,53 @@ namespace geode::comm {
         std::is_convertible_v<PReturn, bool> || std::is_same_v<PReturn, void>;
     }
     bool BasicEvent<Marker, PortTemplate, PReturn(PArgs...), FArgs...>::send(PArgs... args) noexcept(std::is_nothrow_invocable_v<geode::CopyableFunction<PReturn(PArgs...)>, PArgs...>) {
+        if constexpr (IsQueuedPort<PortType>) {
+            if constexpr (!std::is_same_v<EventCenterType, EventCenterGlobal>) {
+                // nothing would ever flush the queue on this thread, and the shared
+                // center's ports belong to the main thread, so queue it over there
+                if (!EventCenterThreadLocal::isProcessedOnCurrentThread()) {
+                    this->postToMain(args...);
+                    return false;
+                }
+            }
+
+            bool scheduleFlush = false;
+            EventCenterType::get()->send(this, [&](OpaquePortBase* opaquePort) {
+                auto port = static_cast<LatestOpaqueEventType*>(opaquePort);
+                scheduleFlush = port->enqueue(args...);
+                return false;
+            }, &BasicEvent::migratePort);
+
+            if (scheduleFlush) {
+                auto flush = [event = Self(CloneMarker{}, m_filter)] {
+                    auto resolved = EventCenterType::get()->resolvePort(&event, &BasicEvent::migratePort);
+                    if (resolved.port) {
+                        static_cast<LatestOpaqueEventType*>(resolved.port.get())->flush();
+                    }
+                };
+                if constexpr (std::is_same_v<EventCenterType, EventCenterGlobal>) {
+                    EventCenterThreadLocal::postToMain(std::move(flush));
+                }
+                else {
+                    EventCenterThreadLocal::postTo(std::this_thread::get_id(), std::move(flush));
+                }
+            }
+            return false;
+        }
+        else if constexpr (IsOncePort<PortType>) {
+            auto center = EventCenterType::get();
+            auto resolved = center->resolvePort(this, &BasicEvent::migratePort);
+            if (!resolved.port) {
+                // the payload has to be kept for late listeners, so there needs to be a port to latch it
+                (void)center->addReceiver(this, [](OpaquePortBase*) {
+                    return ReceiverHandle();
+                }, &BasicEvent::migratePort);
+                resolved = center->resolvePort(this, &BasicEvent::migratePort);
+            }
+            if (!resolved.port) return false;
+            return static_cast<LatestOpaqueEventType*>(resolved.port.get())->send(args...);
+        }
+
         auto ret = EventCenterType::get()->send(this, [&](OpaquePortBase* opaquePort) {
             auto port = static_cast<LatestOpaqueEventType*>(opaquePort);
             return port->send(args...);
@@ -916,12 +1245,87 @@ namespace geode::comm {
         }, &BasicEvent::migratePort);
     }
 
+    template <class Marker, template <class> class PortTemplate, class PReturn, class... PArgs, class... FArgs>
+    requires requires {
+        typename OpaqueEventPort<PortTemplate, PArgs...>;
+        std::is_convertible_v<PReturn, bool> || std::is_same_v<PReturn, void>;
+    }
+    bool BasicEvent<Marker, PortTemplate, PReturn(PArgs...), FArgs...>::Channel::send(PArgs... args) noexcept(std::is_nothrow_invocable_v<geode::CopyableFunction<PReturn(PArgs...)>, PArgs...>) {
+        if constexpr (IsQueuedPort<PortType> || IsOncePort<PortType>) {
+            // these have to go through the event itself to be queued or latched
+            return m_event.send(args...);
+        }
+
+        auto center = EventCenterType::get();
+        if (center != m_center || center->getGeneration() != m_generation) {
+            auto resolved = center->resolvePort(&m_event, &BasicEvent::migratePort);
+            m_center = center;
+            m_port = std::move(resolved.port);
+            m_generation = resolved.generation;
+        }
+
+        if (m_port) {
+            // keep the port alive even if a receiver causes it to be erased
+            auto port = m_port;
+            if (static_cast<LatestOpaqueEventType*>(port.get())->send(args...)) return true;
+        }
+
+        auto legacy = EventCenter::get();
+        if (legacy->isEmpty()) return false;
+
+        // fallback on the old event center
+        return legacy->send(&m_event, [&](OpaquePortBase* opaquePort) {
+            auto port = static_cast<OpaqueEventType*>(opaquePort);
+            return port->send(std::forward<PArgs>(args)...);
+        }, &BasicEvent::migratePort);
+    }
+
+    template <class Marker, template <class> class PortTemplate, class PReturn, class... PArgs, class... FArgs>
+    requires requires {
+        typename OpaqueEventPort<PortTemplate, PArgs...>;
+        std::is_convertible_v<PReturn, bool> || std::is_same_v<PReturn, void>;
+    }
+    bool BasicEvent<Marker, PortTemplate, PReturn(PArgs...), FArgs...>::postTo(std::thread::id thread, PArgs... args) const noexcept {
+        return EventCenterThreadLocal::postTo(thread, [event = Self(CloneMarker{}, m_filter), ...args = std::decay_t<PArgs>(args)] mutable {
+            event.send(args...);
+        });
+    }
+
+    template <class Marker, template <class> class PortTemplate, class PReturn, class... PArgs, class... FArgs>
+    requires requires {
+        typename OpaqueEventPort<PortTemplate, PArgs...>;
+        std::is_convertible_v<PReturn, bool> || std::is_same_v<PReturn, void>;
+    }
+    void BasicEvent<Marker, PortTemplate, PReturn(PArgs...), FArgs...>::postToMain(PArgs... args) const noexcept {
+        EventCenterThreadLocal::postToMain([event = Self(CloneMarker{}, m_filter), ...args = std::decay_t<PArgs>(args)] mutable {
+            event.send(args...);
+        });
+    }
+
     template <class Marker, template <class> class PortTemplate, class PReturn, class... PArgs, class... FArgs>
     requires requires {
         typename OpaqueEventPort<PortTemplate, PArgs...>;
         std::is_convertible_v<PReturn, bool> || std::is_same_v<PReturn, void>;
     }
     ListenerHandle BasicEvent<Marker, PortTemplate, PReturn(PArgs...), FArgs...>::addReceiver(geode::CopyableFunction<PReturn(PArgs...)> rec, int priority) const noexcept {
+        if constexpr (IsOncePort<PortType>) {
+            auto late = rec;
+            auto handle = EventCenterType::get()->addReceiver(this, [&](OpaquePortBase* opaquePort) {
+                auto port = static_cast<LatestOpaqueEventType*>(opaquePort);
+                return port->addReceiver(std::move(rec), priority);
+            }, &BasicEvent::migratePort);
+
+            // the event was already sent, so call the new listener with its payload outside of any locks
+            auto resolved = EventCenterType::get()->resolvePort(this, &BasicEvent::migratePort);
+            if (resolved.port) {
+                auto port = static_cast<LatestOpaqueEventType*>(resolved.port.get());
+                if (auto payload = port->takeLate(handle.m_handle)) {
+                    std::apply(late, *payload);
+                }
+            }
+            return handle;
+        }
+
         return EventCenterType::get()->addReceiver(this, [&](OpaquePortBase* opaquePort) {
             auto port = static_cast<LatestOpaqueEventType*>(opaquePort);
             return port->addReceiver(std::move(rec), priority);
@@ -966,6 +1370,39 @@ namespace geode {
         using comm::BasicEvent<Marker, comm::PortWrapper<comm::Port, true, comm::PortCallableCopy>::type, PFunc, FArgs...>::BasicEvent;
     };
 
+    // Only the first send is delivered, listeners added afterwards get called with it immediately
+    template<class Marker, class PFunc, class... FArgs>
+    struct OnceEvent : public comm::BasicEvent<Marker, comm::PortWrapper<comm::OncePort, false, comm::PortCallableCopy>::type, PFunc, FArgs...> {
+        using comm::BasicEvent<Marker, comm::PortWrapper<comm::OncePort, false, comm::PortCallableCopy>::type, PFunc, FArgs...>::BasicEvent;
+    };
+
+    template<class Marker, class PFunc, class... FArgs>
+    struct ThreadSafeOnceEvent : public comm::BasicEvent<Marker, comm::PortWrapper<comm::OncePort, true, comm::PortCallableCopy>::type, PFunc, FArgs...> {
+        using comm::BasicEvent<Marker, comm::PortWrapper<comm::OncePort, true, comm::PortCallableCopy>::type, PFunc, FArgs...>::BasicEvent;
+    };
+
+    // Sends are delivered later in one batch, see BasicEvent::send
+    template<class Marker, class PFunc, class... FArgs>
+    struct QueuedEvent : public comm::BasicEvent<Marker, comm::PortWrapper<comm::QueuedPort, false, comm::PortCallableCopy>::type, PFunc, FArgs...> {
+        using comm::BasicEvent<Marker, comm::PortWrapper<comm::QueuedPort, false, comm::PortCallableCopy>::type, PFunc, FArgs...>::BasicEvent;
+    };
+
+    template<class Marker, class PFunc, class... FArgs>
+    struct ThreadSafeQueuedEvent : public comm::BasicEvent<Marker, comm::PortWrapper<comm::QueuedPort, true, comm::PortCallableCopy>::type, PFunc, FArgs...> {
+        using comm::BasicEvent<Marker, comm::PortWrapper<comm::QueuedPort, true, comm::PortCallableCopy>::type, PFunc, FArgs...>::BasicEvent;
+    };
+
+    // Like QueuedEvent, but only the latest send before a flush is delivered, useful for progress updates
+    template<class Marker, class PFunc, class... FArgs>
+    struct CoalescedEvent : public comm::BasicEvent<Marker, comm::PortWrapper<comm::CoalescedPort, false, comm::PortCallableCopy>::type, PFunc, FArgs...> {
+        using comm::BasicEvent<Marker, comm::PortWrapper<comm::CoalescedPort, false, comm::PortCallableCopy>::type, PFunc, FArgs...>::BasicEvent;
+    };
+
+    template<class Marker, class PFunc, class... FArgs>
+    struct ThreadSafeCoalescedEvent : public comm::BasicEvent<Marker, comm::PortWrapper<comm::CoalescedPort, true, comm::PortCallableCopy>::type, PFunc, FArgs...> {
+        using comm::BasicEvent<Marker, comm::PortWrapper<comm::CoalescedPort, true, comm::PortCallableCopy>::type, PFunc, FArgs...>::BasicEvent;
+    };
+
 namespace comm {
     template<class Marker, bool ThreadSafe, class GFunc, class PFunc, class... FArgs>
     struct BasicGlobalEvent {};
@@ -1042,6 +1479,39 @@ namespace comm {
             }
         }
 
+        /// Sends through pre-resolved channels, see BasicEvent::Channel. A channel
+        /// resolves both the filtered and the unfiltered port once. Like send, a
+        /// channel of an event without a filter sends nothing.
+        class Channel {
+        private:
+            std::optional<std::tuple<FArgs...>> m_filter;
+            std::optional<typename Event1Type::Channel> m_filtered;
+            typename Event2Type::Channel m_unfiltered;
+
+        public:
+            Channel() noexcept : m_unfiltered(Event2Type().channel()) {}
+            Channel(FArgs... fargs) noexcept
+              : m_filter(std::in_place, fargs...),
+                m_filtered(std::in_place, Event1Type(std::move(fargs)...)),
+                m_unfiltered(Event2Type().channel()) {}
+
+            bool send(PArgs... args) noexcept(std::is_nothrow_invocable_v<geode::CopyableFunction<PReturn(PArgs...)>, PArgs...>) {
+                if (!m_filtered) return false;
+                if (m_filtered->send(args...)) return true;
+                return std::apply([&](auto const&... fargs) {
+                    return m_unfiltered.send(fargs..., std::forward<PArgs>(args)...);
+                }, *m_filter);
+            }
+        };
+
+        /// A channel bound to the filter of this event
+        Channel channel() const noexcept {
+            if (!m_filter) return Channel();
+            return std::apply([](auto const&... fargs) {
+                return Channel(fargs...);
+            }, *m_filter);
+        }
+
         bool send(PArgs... args) noexcept(std::is_nothrow_invocable_v<geode::CopyableFunction<PReturn(PArgs...)>, PArgs...>) {
             if (m_filter.has_value()) {
                 auto filterCopy = *m_filter;
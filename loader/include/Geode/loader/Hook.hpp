@@ -21,6 +21,7 @@ namespace geode {
 
         friend class Mod;
         friend class Loader;
+        friend class HookBatch;
 
     public:
 
@@ -155,6 +156,7 @@ namespace geode {
 
         friend class Mod;
         friend class Loader;
+        friend class HookBatch;
 
     public:
 
@@ -218,4 +220,41 @@ namespace geode {
          */
         [[nodiscard]] matjson::Value getRuntimeInfo() const;
     };
+
+    /**
+     * Enables and disables many hooks and patches in one go. Patch writes are
+     * grouped by memory page, so that every page only has its protection
+     * changed and its instruction cache flushed once, rather than once per
+     * patch. If anything in the batch fails, whatever it already applied is
+     * reverted.
+     * @example
+     * HookBatch batch;
+     * for (auto hook : Mod::get()->getHooks()) {
+     *     batch.disable(hook);
+     * }
+     * GEODE_UNWRAP(batch.commit());
+     */
+    class GEODE_DLL HookBatch final {
+    private:
+        class Impl;
+        std::unique_ptr<Impl> m_impl;
+
+    public:
+        HookBatch();
+        ~HookBatch();
+        HookBatch(HookBatch&& other) noexcept;
+        HookBatch& operator=(HookBatch&& other) noexcept;
+
+        HookBatch& enable(Hook* hook);
+        HookBatch& disable(Hook* hook);
+        HookBatch& enable(Patch* patch);
+        HookBatch& disable(Patch* patch);
+
+        /**
+         * Apply everything in the batch and empty it
+         * @returns Errorful result with info on the first thing that failed,
+         * in which case nothing in the batch was applied
+         */
+        Result<> commit();
+    };
 }
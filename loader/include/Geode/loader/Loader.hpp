@@ -8,6 +8,7 @@
 #include "Types.hpp"
 
 #include <atomic>
+#include <chrono>
 #include <matjson.hpp>
 #include <mutex>
 #include <optional>
@@ -16,6 +17,32 @@
 namespace geode {
     using ScheduledFunction = geode::Function<void()>;
 
+    /**
+     * The lanes of the main thread queue. Lanes run in this order every frame,
+     * and every lane runs in the order functions were queued.
+     */
+    enum class MainThreadPriority : uint8_t {
+        /// Always runs in full, no matter the frame budget. Meant for work that
+        /// reacts to input and would feel laggy if it was deferred
+        InputCritical = 0,
+        /// The default. Spills over to the next frame once the budget is spent
+        UI = 1,
+        /// Only runs with budget left over from the other lanes
+        Background = 2,
+    };
+
+    struct MainThreadLaneMetrics {
+        /// Functions waiting in the lane
+        size_t queueDepth = 0;
+        /// Functions that ran during the last frame
+        size_t executedLastFrame = 0;
+        /// Time between queueing and running, over the functions that ran during the last frame
+        std::chrono::microseconds averageLatency{0};
+        std::chrono::microseconds maxLatency{0};
+        /// Queue nodes allocated so far, which stops growing once the lane recycles enough of them
+        size_t allocatedNodes = 0;
+    };
+
     struct LoadProblem {
         enum class Type : uint8_t {
             /// Some other fatal error (like binary loading failing)
@@ -125,6 +152,16 @@ namespace geode {
         }
 
         void queueInMainThread(ScheduledFunction&& func);
+        void queueInMainThread(ScheduledFunction&& func, MainThreadPriority priority);
+
+        /**
+         * Sets how long the main thread queue may run for every frame. Functions of the
+         * UI and background lanes that do not fit in the budget run on the next frame,
+         * though every lane runs at least one function a frame. Defaults to 8ms.
+         */
+        void setMainThreadBudget(std::chrono::microseconds budget);
+        std::chrono::microseconds getMainThreadBudget() const;
+        MainThreadLaneMetrics getMainThreadLaneMetrics(MainThreadPriority priority) const;
 
         /**
          * Returns the current game version.
@@ -157,6 +194,16 @@ namespace geode {
         Loader::get()->queueInMainThread(std::move(func));
     }
 
+    /**
+     * @brief Queues a function to run on the main thread in a specific lane
+     *
+     * @param func the function to queue
+     * @param priority the lane to queue it in, see MainThreadPriority
+    */
+    inline void queueInMainThread(ScheduledFunction&& func, MainThreadPriority priority) {
+        Loader::get()->queueInMainThread(std::move(func), priority);
+    }
+
     /**
      * @brief Take the next mod to load
      *
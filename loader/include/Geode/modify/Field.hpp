@@ -5,6 +5,7 @@
 #include <Geode/loader/Loader.hpp>
 #include <Geode/utils/function.hpp>
 #include <cocos2d.h>
+#include <cstddef>
 #include <vector>
 
 namespace cocos2d {
@@ -17,6 +18,9 @@ namespace geode {
 }
 
 namespace geode::modifier {
+    // The container mods built with older headers use for their fields,
+    // through CCNode::getFieldContainer and getFieldIndexForClass. Its layout
+    // is part of their inline code, so it must not change
     class FieldContainer {
     private:
         std::vector<void*> m_containedFields;
@@ -53,6 +57,105 @@ namespace geode::modifier {
 
     GEODE_DLL size_t getFieldIndexForClass(char const* name);
 
+    // Where each `Fields` struct registered for a modified class lives inside
+    // the block of a field arena. Every registration makes a new layout,
+    // arenas keep the one that was current when they were created
+    struct FieldLayout final {
+        struct Entry {
+            size_t offset;
+            size_t size;
+            size_t align;
+            void (*destructor)(void*);
+        };
+
+        std::vector<Entry> entries;
+        // the block starts with a constructed flag per entry, followed by the entries
+        size_t size = 0;
+        size_t align = 1;
+    };
+
+    // The start of the metadata the loader attaches to nodes, holding their
+    // field arenas so that m_fields can find one that already exists without
+    // calling into the loader. Only the loader creates it
+    class NodeFieldTable : public cocos2d::CCObject {
+    protected:
+        // indexed by the class index of the modified class
+        std::vector<FieldArena*> m_classFieldArenas;
+
+        NodeFieldTable() = default;
+
+    public:
+        // the metadata is told apart from other user objects by its tag
+        static constexpr int TAG = 0xB324ABC;
+
+        FieldArena* findFieldArena(size_t classIndex) const {
+            return classIndex < m_classFieldArenas.size() ? m_classFieldArenas[classIndex] : nullptr;
+        }
+    };
+
+    // The fields of every mod that modifies a class, for a single node. The
+    // fields that were registered when the arena was created share one
+    // allocation with it
+    class GEODE_DLL FieldArena final {
+    private:
+        size_t m_class;
+        FieldLayout const* m_layout;
+        std::byte* m_block;
+        // fields registered after this arena was created are allocated separately
+        std::vector<void*> m_overflow;
+
+        FieldArena(size_t classIndex, FieldLayout const* layout, std::byte* block);
+        ~FieldArena();
+
+        void* getOverflowField(size_t index);
+        void* setOverflowField(size_t index);
+
+    public:
+        FieldArena(FieldArena const&) = delete;
+        FieldArena& operator=(FieldArena const&) = delete;
+
+        static FieldArena* create(size_t classIndex);
+        static void destroy(FieldArena* arena);
+
+        // Returns the fields at the index, or nullptr if they haven't been constructed yet
+        void* getField(size_t index) {
+            if (index < m_layout->entries.size()) {
+                if (m_block[index] == std::byte{0}) return nullptr;
+                return m_block + m_layout->entries[index].offset;
+            }
+            return this->getOverflowField(index);
+        }
+
+        // Returns the storage for the fields at the index and marks them as
+        // constructed, they have to be constructed in it right away
+        void* setField(size_t index) {
+            if (index < m_layout->entries.size()) {
+                m_block[index] = std::byte{1};
+                return m_block + m_layout->entries[index].offset;
+            }
+            return this->setOverflowField(index);
+        }
+
+        static FieldArena* from(cocos2d::CCNode* node, size_t classIndex) {
+            // the arena usually exists already, which is read inline
+            auto object = node->m_pUserObject;
+            if (object && object->m_nTag == NodeFieldTable::TAG) {
+                if (auto arena = static_cast<NodeFieldTable*>(object)->findFieldArena(classIndex)) {
+                    return arena;
+                }
+            }
+            return node->getFieldArena(classIndex);
+        }
+    };
+
+    // Returns the dense index of a modified class by its type name, the same
+    // for every mod. Field arenas are looked up by it
+    GEODE_DLL size_t getFieldClassIndex(char const* name);
+
+    // Adds the fields of a modify to the layout of the modified class and
+    // returns their index, which is global across all mods
+    GEODE_DLL size_t registerFieldsForClass(size_t classIndex, size_t size, size_t align, void (*destructor)(void*));
+
     template <class Parent, class Base>
     class FieldIntermediate {
         using Intermediate = Modify<Parent, Base>;
@@ -77,6 +180,34 @@ namespace geode::modifier {
             static_cast<typename Parent::Fields*>(offsetField)->~Fields();
         }
 
+        struct Slot {
+            size_t classIndex;
+            size_t fieldIndex;
+        };
+
+        // registered by the modify on load, so that nodes created afterwards
+        // have room for the fields from the start. both indices share one
+        // static so that m_fields only checks a single guard
+        static Slot const& slot() {
+            static Slot slot = [] {
+                auto classIndex = getFieldClassIndex(typeid(Base).name());
+                // the index is global across all mods, so the
+                // function is defined in the loader source
+                auto fieldIndex = registerFieldsForClass(
+                    classIndex,
+                    sizeof(typename Parent::Fields),
+                    alignof(typename Parent::Fields),
+                    &FieldIntermediate::fieldDestructor
+                );
+                return Slot { classIndex, fieldIndex };
+            }();
+            return slot;
+        }
+
+        static size_t fieldIndex() {
+            return FieldIntermediate::slot().fieldIndex;
+        }
+
         auto self() {
             static_assert(
                 std::is_base_of_v<cocos2d::CCNode, Base>,
@@ -89,21 +220,17 @@ namespace geode::modifier {
             auto node = reinterpret_cast<Parent*>(reinterpret_cast<std::byte*>(this) - sizeof(Base));
             // static_assert(sizeof(Base) + sizeof() == sizeof(Intermediate), "offsetof not correct");
 
-            // generating the container if it doesn't exist
-            auto container = FieldContainer::from(node, typeid(Base).name());
+            auto const& slot = FieldIntermediate::slot();
+            auto index = slot.fieldIndex;
 
-            // the index is global across all mods, so the
-            // function is defined in the loader source
-            static size_t index = getFieldIndexForClass(typeid(Base).name());
+            // generating the arena if it doesn't exist
+            auto arena = FieldArena::from(node, slot.classIndex);
 
             // the fields are actually offset from their original
             // offset, this is done to save on allocation and space
-            auto offsetField = container->getField(index);
+            auto offsetField = arena->getField(index);
             if (!offsetField) {
-                offsetField = container->setField(
-                    index, sizeof(typename Parent::Fields), &FieldIntermediate::fieldDestructor
-                );
-
+                offsetField = arena->setField(index);
                 FieldIntermediate::fieldConstructor(offsetField);
             }
 
@@ -405,6 +405,11 @@ namespace geode::modifier {
                 "\n---"
             );
 
+            using FieldBase = typename ModifyDerived::Base;
+            if constexpr (std::is_base_of_v<cocos2d::CCNode, FieldBase> && requires { typename ModifyDerived::Derived::Fields; }) {
+                (void)FieldIntermediate<typename ModifyDerived::Derived, FieldBase>::fieldIndex();
+            }
+
             // i really dont want to recompile codegen
             auto test = static_cast<ModifyDerived*>(this);
             test->ModifyDerived::apply();
@@ -98,6 +98,10 @@ namespace geode {
         float getKerning(char32_t first, char32_t second) const noexcept;
 
     private:
+        // Binary form of the parsed font, cached so .fnt files aren't parsed every launch
+        bool initWithCache(ByteSpan data);
+        ByteVector toCache() const;
+
         std::string m_atlasName;
         std::string m_fntFilename;
         std::unordered_map<uint32_t, CharDef> m_characters;
@@ -158,6 +158,8 @@ namespace geode {
             std::recursive_mutex m_mutex;
             Status m_status = Status::Pending;
             std::optional<Type> m_resultValue;
+            // the latest progress value, while its delivery is queued
+            std::optional<P> m_pendingProgress;
             bool m_finalEventPosted = false;
             std::string m_name;
             std::unique_ptr<ExtraData> m_extraData = nullptr;
@@ -311,8 +313,18 @@ namespace geode {
             if (!handle) return;
             std::unique_lock<std::recursive_mutex> lock(handle->m_mutex);
             if (handle->m_status == Status::Pending) {
-                queueInMainThread([handle, value = std::move(value)]() mutable {
-                    // Event::createProgressed(handle, &value).post();
+                // only one delivery is queued at a time, values posted before it
+                // runs replace the pending one
+                bool queued = handle->m_pendingProgress.has_value();
+                handle->m_pendingProgress.emplace(std::move(value));
+                if (queued) return;
+                queueInMainThread([handle]() mutable {
+                    std::unique_lock<std::recursive_mutex> lock(handle->m_mutex);
+                    auto value = std::move(handle->m_pendingProgress);
+                    handle->m_pendingProgress.reset();
+                    lock.unlock();
+                    if (!value) return;
+                    // Event::createProgressed(handle, &*value).post();
                 });
             }
         }
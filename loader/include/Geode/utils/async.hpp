@@ -6,12 +6,60 @@
 #include <arc/task/CancellationToken.hpp>
 #include <Geode/utils/function.hpp>
 #include <Geode/loader/Loader.hpp>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <optional>
 
 namespace geode::async {
 
 /// Gets the main arc Runtime, prefer running all async code inside this runtime.
 GEODE_DLL arc::Runtime& runtime();
 
+/// Thread pools for blocking work, next to the arc runtime. Each lane has its own threads,
+/// so a burst of work in one lane can not starve the other.
+enum class BlockingLane : uint8_t {
+    /// File and network IO. Has a small, fixed number of threads
+    IO = 0,
+    /// CPU heavy work like decoding and decompression. Has a thread per core,
+    /// idle threads steal queued work from busy ones
+    CPU = 1,
+};
+
+struct BlockingLaneMetrics {
+    static constexpr size_t BUCKET_COUNT = 8;
+    /// Upper bounds of the histogram buckets, the last bucket holds everything above them
+    static constexpr std::array<std::chrono::microseconds, BUCKET_COUNT - 1> BUCKET_BOUNDS = {
+        std::chrono::microseconds(100),
+        std::chrono::milliseconds(1),
+        std::chrono::milliseconds(4),
+        std::chrono::milliseconds(16),
+        std::chrono::milliseconds(64),
+        std::chrono::milliseconds(256),
+        std::chrono::seconds(1),
+    };
+
+    size_t workers = 0;
+    /// Functions waiting for a thread
+    size_t queueDepth = 0;
+    /// Functions running right now
+    size_t active = 0;
+    size_t completed = 0;
+    /// Time between spawning and starting to run
+    std::array<size_t, BUCKET_COUNT> waitHistogram{};
+    /// Time spent running
+    std::array<size_t, BUCKET_COUNT> runHistogram{};
+};
+
+/// Runs a blocking function on one of the threads of the given lane
+GEODE_DLL void spawnBlocking(BlockingLane lane, Function<void()> func);
+GEODE_DLL BlockingLaneMetrics getBlockingLaneMetrics(BlockingLane lane);
+
+/// Queues the given function to run in the main thread once the delay has passed,
+/// without keeping the main thread busy until then
+GEODE_DLL void queueInMainThreadAfter(std::chrono::milliseconds delay, Function<void()> func);
+
 /// Asynchronously spawns a future, then invokes the given callback on the main thread when it completes.
 /// Overload for function objects that return a Future, i.e. `[] -> arc::Future {}`
 template <
@@ -213,6 +261,97 @@ auto waitForMainThread(F&& func) {
     return WaitForMainAwaiter<T>(std::forward<F>(func));
 }
 
+/// Delivers progress values to a callback on the main thread, where the latest value wins.
+/// Values can be posted from any thread as often as wanted, but only one delivery is queued
+/// at a time, so the callback runs at most once per frame and never more often than the
+/// given interval. Intermediate values are dropped. Copies of a slot share the same state.
+template <typename P>
+class ProgressSlot {
+public:
+    using Callback = Function<void(P)>;
+
+    ProgressSlot() = default;
+    explicit ProgressSlot(Callback callback, std::chrono::milliseconds interval = std::chrono::milliseconds(0))
+        : m_state(std::make_shared<State>(std::move(callback), interval)) {}
+
+    /// Replaces the pending value, and queues a delivery if there is none queued yet
+    void post(P value) {
+        if (!m_state || m_state->m_closed.load(std::memory_order::acquire)) return;
+        {
+            std::lock_guard lock(m_state->m_mutex);
+            m_state->m_latest = std::move(value);
+        }
+        if (!m_state->m_queued.exchange(true, std::memory_order::acq_rel)) {
+            schedule(m_state);
+        }
+    }
+
+    /// Drops the pending value and stops delivering, for every copy of this slot
+    void close() {
+        if (m_state) {
+            m_state->m_closed.store(true, std::memory_order::release);
+        }
+    }
+
+    explicit operator bool() const {
+        return m_state != nullptr;
+    }
+
+private:
+    struct State {
+        std::mutex m_mutex;
+        std::optional<P> m_latest;
+        Callback m_callback;
+        std::chrono::milliseconds m_interval;
+        std::chrono::steady_clock::time_point m_lastDelivery;
+        std::atomic_bool m_queued = false;
+        std::atomic_bool m_closed = false;
+
+        State(Callback callback, std::chrono::milliseconds interval)
+            : m_callback(std::move(callback)), m_interval(interval) {}
+
+        ~State() {
+            // the callback may capture objects that must be destroyed on the main thread
+            geode::queueInMainThread([_ = std::move(m_callback)] {});
+        }
+    };
+
+    std::shared_ptr<State> m_state;
+
+    static void schedule(std::shared_ptr<State> state) {
+        geode::queueInMainThread([state = std::move(state)] {
+            deliver(state);
+        });
+    }
+
+    static void deliver(std::shared_ptr<State> const& state) {
+        if (state->m_closed.load(std::memory_order::acquire)) return;
+
+        auto now = std::chrono::steady_clock::now();
+        if (auto early = state->m_lastDelivery + state->m_interval - now; early.count() > 0) {
+            // too early, deliver once the interval is over instead of checking every frame
+            queueInMainThreadAfter(
+                std::chrono::ceil<std::chrono::milliseconds>(early),
+                [state] { deliver(state); }
+            );
+            return;
+        }
+
+        // clear the flag before taking the value, so a value posted in between
+        // either gets taken here or queues its own delivery
+        state->m_queued.store(false, std::memory_order::release);
+        std::optional<P> value;
+        {
+            std::lock_guard lock(state->m_mutex);
+            value.swap(state->m_latest);
+        }
+        if (!value) return;
+
+        state->m_lastDelivery = now;
+        state->m_callback(std::move(*value));
+    }
+};
+
 /// Allows an async task to be spawned and then automatically aborted when the holder goes out of scope.
 template <typename Ret = void>
 class TaskHolder {
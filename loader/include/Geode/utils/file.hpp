@@ -11,6 +11,7 @@
 #include <Geode/utils/function.hpp>
 #include <Geode/utils/async.hpp>
 #include <filesystem>
+#include <optional>
 #include <string>
 #include <unordered_set>
 
@@ -231,6 +232,19 @@ namespace geode::utils::file {
          */
         bool hasEntry(Path const& name);
 
+        struct EntryInfo {
+            bool isDirectory;
+            uint32_t crc32;
+            uint64_t size;
+        };
+        /**
+         * Get the CRC32 and uncompressed size of an entry, as recorded in the
+         * zip's central directory, so this does not decompress anything
+         * @param name Entry path in zip
+         * @returns The entry info, or nullopt if there is no such entry
+         */
+        std::optional<EntryInfo> getEntryInfo(Path const& name) const;
+
         /**
          * Extract entry to memory
          * @param name Entry path in zip
@@ -247,6 +261,12 @@ namespace geode::utils::file {
          * @param dir Directory to unzip the contents to
          */
         Result<> extractAllTo(Path const& dir);
+        /**
+         * Extract the entries for which the filter returns true to directory
+         * @param dir Directory to unzip the contents to
+         * @param filter Called with the path of every entry in zip
+         */
+        Result<> extractAllTo(Path const& dir, geode::Function<bool(Path const&)> filter);
 
         /**
          * Helper method for quickly unzipping a file
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <Geode/DefaultInclude.hpp>
+#include <chrono>
+#include <string>
+#include <string_view>
+
+namespace geode {
+    class Mod;
+    Mod* getMod();
+}
+
+namespace geode::trace {
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * Whether spans are being recorded. Tracing is enabled by launching the
+     * game with `--geode:trace-startup=true`; the recorded timeline is then
+     * written to `geode/logs/startup-trace.json` in Chrome's trace event
+     * format once the game has finished loading, and recording stops.
+     * Open it with `chrome://tracing` or https://ui.perfetto.dev
+     */
+    GEODE_DLL bool isEnabled();
+
+    /**
+     * Record a span that has already happened on the calling thread
+     * @param name Name of the span
+     * @param mod The mod the span is attributed to
+     * @param begin When the span began
+     * @param end When the span ended
+     */
+    GEODE_DLL void addSpan(std::string_view name, Mod* mod, Clock::time_point begin, Clock::time_point end);
+
+    /**
+     * Records the time between its construction and destruction as a span on
+     * the calling thread. Does nothing if tracing is not enabled
+     * @example
+     * {
+     *     trace::Span span("Loading my textures");
+     *     ...
+     * }
+     */
+    class Span final {
+        std::string m_name;
+        Mod* m_mod = nullptr;
+        Clock::time_point m_begin;
+        bool m_enabled = false;
+
+    public:
+        Span(std::string_view name, Mod* mod = geode::getMod()) : m_enabled(isEnabled()) {
+            if (m_enabled) {
+                m_name = name;
+                m_mod = mod;
+                m_begin = Clock::now();
+            }
+        }
+        ~Span() {
+            if (m_enabled) {
+                addSpan(m_name, m_mod, m_begin, Clock::now());
+            }
+        }
+
+        Span(Span const&) = delete;
+        Span& operator=(Span const&) = delete;
+    };
+}
@@ -445,6 +445,13 @@ namespace geode::utils::web {
          */
         WebRequest& onProgress(Function<void(WebProgress const&)> callback);
 
+        /**
+         * Sets the minimum time between two calls of the progress callbacks. Progress is
+         * always coalesced to the latest value, and delivered at most once per frame.
+         * Defaults to 0, which means every frame.
+         */
+        WebRequest& progressInterval(std::chrono::milliseconds interval);
+
         /**
          * Gets the unique request ID
          *
@@ -5,7 +5,13 @@
 #include <Geode/utils/ranges.hpp>
 #include <Geode/utils/terminate.hpp>
 #include <Geode/utils/StringMap.hpp>
+#include <Geode/utils/coro.hpp>
 #include <cocos2d.h>
+#include <algorithm>
+#include <cstring>
+#include <new>
+#include <optional>
+#include <span>
 #include <queue>
 #include <stack>
 
@@ -15,20 +21,86 @@ using namespace geode::modifier;
 #pragma warning(push)
 #pragma warning(disable : 4273)
 
-constexpr auto METADATA_TAG = 0xB324ABC;
+constexpr auto METADATA_TAG = NodeFieldTable::TAG;
 
 struct ProxyCCNode;
 
-class GeodeNodeMetadata final : public cocos2d::CCObject {
+// The descendants of a node by their ID, see CCNode::setIDIndexEnabled. The
+// nodes are held weakly, as nothing stops a node from leaving the tree (and
+// being freed) without going through the hooks that keep this up to date
+class IDIndex final {
 private:
-    StringMap<FieldContainer*> m_classFieldContainers;
+    StringMap<std::vector<WeakRef<CCNode>>> m_nodes;
+
+public:
+    IDIndex() = default;
+    IDIndex(IDIndex const&) = delete;
+    IDIndex& operator=(IDIndex const&) = delete;
+
+    void add(std::string_view id, CCNode* node) {
+        if (id.empty()) return;
+        auto it = m_nodes.find(id);
+        if (it == m_nodes.end()) {
+            it = m_nodes.emplace(std::string(id), std::vector<WeakRef<CCNode>>()).first;
+        }
+        it->second.push_back(node);
+    }
+
+    void remove(std::string_view id, CCNode* node) {
+        if (id.empty()) return;
+        auto it = m_nodes.find(id);
+        if (it == m_nodes.end()) return;
+        std::erase(it->second, node);
+        if (it->second.empty()) {
+            m_nodes.erase(it);
+        }
+    }
+
+    // Adds the node and all of its descendants
+    void addTree(CCNode* node) {
+        this->add(node->getID(), node);
+        for (auto child : CCArrayExt<CCNode*>(node->getChildren())) {
+            this->addTree(child);
+        }
+    }
+
+    // Removes the node and all of its descendants
+    void removeTree(CCNode* node) {
+        this->remove(node->getID(), node);
+        for (auto child : CCArrayExt<CCNode*>(node->getChildren())) {
+            this->removeTree(child);
+        }
+    }
+
+    // Check the entries with lock(), a null one has been freed already
+    std::span<WeakRef<CCNode> const> find(std::string_view id) const {
+        auto it = m_nodes.find(id);
+        if (it == m_nodes.end()) return {};
+        return it->second;
+    }
+};
+
+class GeodeNodeMetadata final : public NodeFieldTable {
+private:
+    // Things few nodes ever have, kept out of the metadata itself so that
+    // the common case of just an ID or some fields stays small
+    struct Extras {
+        StringMap<Ref<CCObject>> userObjects;
+        std::vector<Ref<CCObject>> tethers;
+        StringSet userFlags;
+        StringMultimap<std::unique_ptr<ListenerHandle>> eventListeners;
+        std::unique_ptr<IDIndex> idIndex;
+        // the fields of mods built with older headers, by class index
+        std::vector<std::unique_ptr<FieldContainer>> legacyFieldContainers;
+    };
+
     std::string m_id = "";
     Ref<Layout> m_layout = nullptr;
     Ref<LayoutOptions> m_layoutOptions = nullptr;
-    StringMap<Ref<CCObject>> m_userObjects;
-    std::vector<Ref<CCObject>> m_tethers;
-    StringSet m_userFlags;
-    StringMultimap<std::unique_ptr<ListenerHandle>> m_eventListeners;
+    std::unique_ptr<Extras> m_extras;
+    // whether the node or one of its ancestors has an ID index, so that the
+    // tree hooks of nodes outside of any indexed subtree don't do anything
+    bool m_underIDIndex = false;
 
     friend class ProxyCCNode;
     friend class cocos2d::CCNode;
@@ -36,19 +108,41 @@ private:
     GeodeNodeMetadata() {}
 
     virtual ~GeodeNodeMetadata() {
-        for (auto& [_, container] : m_classFieldContainers) {
-            delete container;
+        for (auto arena : m_classFieldArenas) {
+            if (arena) {
+                FieldArena::destroy(arena);
+            }
         }
     }
 
+    Extras& extras() {
+        if (!m_extras) {
+            m_extras = std::make_unique<Extras>();
+        }
+        return *m_extras;
+    }
+
 public:
+    // Returns the metadata of the node without creating it if it has none,
+    // for anything that only reads
+    static GeodeNodeMetadata* get(CCNode* target) {
+        if (!target) return nullptr;
+
+        auto old = target->m_pUserObject;
+        if (old && old->m_nTag == METADATA_TAG) {
+            return static_cast<GeodeNodeMetadata*>(old);
+        }
+        return nullptr;
+    }
+
     static GeodeNodeMetadata* set(CCNode* target) {
         if (!target) return nullptr;
 
         auto old = target->m_pUserObject;
         // faster than dynamic_cast, technically can
-        // but extremely unlikely to fail
-        if (old && old->getTag() == METADATA_TAG) {
+        // but extremely unlikely to fail. the tag is read
+        // directly as this is on the path of every m_fields access
+        if (old && old->m_nTag == METADATA_TAG) {
             return static_cast<GeodeNodeMetadata*>(old);
         }
         auto meta = new GeodeNodeMetadata();
@@ -67,89 +161,198 @@ public:
         return meta;
     }
 
-    FieldContainer* getFieldContainer(char const* forClass) {
-        auto it = m_classFieldContainers.find(forClass);
-        if (it != m_classFieldContainers.end()) {
-            return it->second;
+    FieldArena* getFieldArena(size_t classIndex) {
+        if (classIndex < m_classFieldArenas.size()) {
+            if (auto arena = m_classFieldArenas[classIndex]) {
+                return arena;
+            }
+        }
+        else {
+            m_classFieldArenas.resize(classIndex + 1, nullptr);
         }
 
-        auto container = new FieldContainer();
-        m_classFieldContainers.insert(it, std::make_pair(forClass, container));
+        auto arena = FieldArena::create(classIndex);
+        m_classFieldArenas[classIndex] = arena;
+        return arena;
+    }
 
-        return container;
+    FieldContainer* getLegacyFieldContainer(size_t classIndex) {
+        auto& containers = this->extras().legacyFieldContainers;
+        if (containers.size() <= classIndex) {
+            containers.resize(classIndex + 1);
+        }
+        auto& container = containers[classIndex];
+        if (!container) {
+            container = std::make_unique<FieldContainer>();
+        }
+        return container.get();
     }
 
     CCObject* getUserObject(std::string_view id) {
-        auto it = m_userObjects.find(id);
-        return it != m_userObjects.end() ? it->second : nullptr;
+        if (!m_extras) return nullptr;
+        auto it = m_extras->userObjects.find(id);
+        return it != m_extras->userObjects.end() ? it->second : nullptr;
     }
 
     void setUserObject(std::string id, CCObject* object) {
         if (object) {
-            auto it = m_userObjects.find(id);
-            if (it == m_userObjects.end()) {
-                m_userObjects.emplace(std::move(id), object);
+            auto& userObjects = this->extras().userObjects;
+            auto it = userObjects.find(id);
+            if (it == userObjects.end()) {
+                userObjects.emplace(std::move(id), object);
             } else {
                 it->second = object;
             }
-        } else {
-            m_userObjects.erase(id);
+        } else if (m_extras) {
+            m_extras->userObjects.erase(id);
         }
     }
 
     void addTether(CCObject* object) {
-        if (!utils::ranges::contains(m_tethers, object)) {
-            m_tethers.emplace_back(object);
+        auto& tethers = this->extras().tethers;
+        if (!utils::ranges::contains(tethers, object)) {
+            tethers.emplace_back(object);
         }
     }
 
     void removeTether(CCObject* object) {
-        utils::ranges::remove(m_tethers, object);
+        if (m_extras) {
+            utils::ranges::remove(m_extras->tethers, object);
+        }
     }
 
     bool getUserFlag(std::string_view id) {
-        return m_userFlags.contains(id);
+        return m_extras && m_extras->userFlags.contains(id);
     }
 
     void setUserFlag(std::string id, bool state) {
         if (state) {
-            m_userFlags.emplace(std::move(id));
-        } else {
-            m_userFlags.erase(id);
+            this->extras().userFlags.emplace(std::move(id));
+        } else if (m_extras) {
+            m_extras->userFlags.erase(id);
         }
     }
 
     ListenerHandle* getEventListener(std::string_view id) {
-        auto it = m_eventListeners.find(id);
-        return it != m_eventListeners.end() ? it->second.get() : nullptr;
+        if (!m_extras) return nullptr;
+        auto it = m_extras->eventListeners.find(id);
+        return it != m_extras->eventListeners.end() ? it->second.get() : nullptr;
     }
 
     ListenerHandle* addEventListener(std::string id, ListenerHandle handle) {
         auto wrap = std::make_unique<ListenerHandle>(std::move(handle));
         auto ret = wrap.get();
-        m_eventListeners.emplace(std::move(id), std::move(wrap));
+        this->extras().eventListeners.emplace(std::move(id), std::move(wrap));
         return ret;
     }
 
     void removeEventListener(std::string_view id) {
-        auto range = m_eventListeners.equal_range(id);
-        m_eventListeners.erase(range.first, range.second);
+        if (!m_extras) return;
+        auto range = m_extras->eventListeners.equal_range(id);
+        m_extras->eventListeners.erase(range.first, range.second);
     }
 
     void removeEventListener(ListenerHandle* handle) {
-        std::erase_if(m_eventListeners, [=](auto& l) {
+        if (!m_extras) return;
+        std::erase_if(m_extras->eventListeners, [=](auto& l) {
             return l.second.get() == handle;
         });
     }
 
     size_t getEventListenerCount() {
-        return m_eventListeners.size();
+        return m_extras ? m_extras->eventListeners.size() : 0;
+    }
+
+    IDIndex* getIDIndex() {
+        return m_extras ? m_extras->idIndex.get() : nullptr;
+    }
+
+    bool isUnderIDIndex() const {
+        return m_underIDIndex;
+    }
+
+    void setUnderIDIndex(bool under) {
+        m_underIDIndex = under;
     }
 };
 
+static IDIndex* getIDIndex(CCNode* node) {
+    auto meta = GeodeNodeMetadata::get(node);
+    return meta ? meta->getIDIndex() : nullptr;
+}
+
+static bool isUnderIDIndex(CCNode* node) {
+    auto meta = GeodeNodeMetadata::get(node);
+    return meta && meta->isUnderIDIndex();
+}
+
+// Marks the node and its descendants as being under an index or not. Nodes
+// that have an index of their own stay marked, as does everything under them
+static void markUnderIDIndex(CCNode* node, bool under) {
+    under = under || getIDIndex(node);
+    if (under) {
+        GeodeNodeMetadata::set(node)->setUnderIDIndex(true);
+    }
+    else if (auto meta = GeodeNodeMetadata::get(node)) {
+        // nothing below an unmarked node is marked unless it has its own index
+        if (!meta->isUnderIDIndex()) return;
+        meta->setUnderIDIndex(false);
+    }
+    else {
+        return;
+    }
+    for (auto child : CCArrayExt<CCNode*>(node->getChildren())) {
+        markUnderIDIndex(child, under);
+    }
+}
+
+// Calls the function with the index of the node and of each of its ancestors that have one
+template <class F>
+static void forEachIDIndex(CCNode* node, F&& func) {
+    if (!isUnderIDIndex(node)) return;
+    for (; node; node = node->getParent()) {
+        if (auto index = getIDIndex(node)) {
+            func(*index);
+        }
+    }
+}
+
 // proxy forwards
 #include <Geode/modify/CCNode.hpp>
 struct ProxyCCNode : Modify<ProxyCCNode, CCNode> {
+    // keeping ID indexes up to date
+    void addChild(CCNode* child, int zOrder, int tag) {
+        CCNode::addChild(child, zOrder, tag);
+        if (child && child->getParent() == this && isUnderIDIndex(this)) {
+            forEachIDIndex(this, [&](IDIndex& index) {
+                index.addTree(child);
+            });
+            markUnderIDIndex(child, true);
+        }
+    }
+    void removeChild(CCNode* child, bool cleanup) {
+        if (child && child->getParent() == this && isUnderIDIndex(this)) {
+            forEachIDIndex(this, [&](IDIndex& index) {
+                index.removeTree(child);
+            });
+            markUnderIDIndex(child, false);
+        }
+        CCNode::removeChild(child, cleanup);
+    }
+    void removeAllChildrenWithCleanup(bool cleanup) {
+        if (isUnderIDIndex(this)) {
+            forEachIDIndex(this, [&](IDIndex& index) {
+                for (auto child : CCArrayExt<CCNode*>(m_pChildren)) {
+                    index.removeTree(child);
+                }
+            });
+            for (auto child : CCArrayExt<CCNode*>(m_pChildren)) {
+                markUnderIDIndex(child, false);
+            }
+        }
+        CCNode::removeAllChildrenWithCleanup(cleanup);
+    }
+
     virtual CCObject* getUserObject() {
         if (auto asNode = typeinfo_cast<CCNode*>(this)) {
             return asNode->getUserObject("");
@@ -173,22 +376,201 @@ struct ProxyCCNode : Modify<ProxyCCNode, CCNode> {
 };
 
 // it is mostly safe to use string_view here to reduce heap allocations,
-// since passed names are obtained by typed().name() which is static
-static inline std::unordered_map<std::string_view, size_t> s_nextIndex;
+// since passed names are obtained by typed().name() which is static.
+// modifies ask for these during static initialization, hence the functions
+static std::unordered_map<std::string_view, size_t>& getFieldClassIndices() {
+    static std::unordered_map<std::string_view, size_t> indices;
+    return indices;
+}
+
+// indexed by class index. layouts are never freed, as arenas made
+// before a registration keep using the layout they were created with
+static std::vector<FieldLayout const*>& getFieldLayouts() {
+    static std::vector<FieldLayout const*> layouts;
+    return layouts;
+}
+
+static FieldLayout const* getFieldLayout(size_t classIndex) {
+    return getFieldLayouts().at(classIndex);
+}
+
+size_t modifier::getFieldClassIndex(char const* name) {
+    auto& indices = getFieldClassIndices();
+    auto [it, inserted] = indices.try_emplace(name, indices.size());
+    if (inserted) {
+        getFieldLayouts().push_back(new FieldLayout());
+    }
+    return it->second;
+}
+
+// the indices of mods built with older headers, which get their own containers
+static std::unordered_map<std::string_view, size_t>& getLegacyFieldIndices() {
+    static std::unordered_map<std::string_view, size_t> indices;
+    return indices;
+}
+
 size_t modifier::getFieldIndexForClass(char const* name) {
-	return s_nextIndex[name]++;
+    return getLegacyFieldIndices()[name]++;
+}
+
+size_t modifier::registerFieldsForClass(size_t classIndex, size_t size, size_t align, void (*destructor)(void*)) {
+    auto& current = getFieldLayouts().at(classIndex);
+    auto layout = new FieldLayout();
+    layout->entries = current->entries;
+    layout->entries.push_back({ .size = size, .align = align, .destructor = destructor });
+
+    // the constructed flags come first, one byte each
+    size_t offset = layout->entries.size();
+    for (auto& entry : layout->entries) {
+        offset = (offset + entry.align - 1) & ~(entry.align - 1);
+        entry.offset = offset;
+        offset += entry.size;
+        layout->align = std::max(layout->align, entry.align);
+    }
+    layout->size = offset;
+
+    current = layout;
+    return layout->entries.size() - 1;
+}
+
+FieldArena::FieldArena(size_t classIndex, FieldLayout const* layout, std::byte* block)
+  : m_class(classIndex), m_layout(layout), m_block(block) {
+    std::memset(m_block, 0, m_layout->entries.size());
+}
+
+FieldArena::~FieldArena() {
+    auto const& entries = m_layout->entries;
+    for (size_t i = 0; i < entries.size(); i++) {
+        if (m_block[i] != std::byte{0}) {
+            entries[i].destructor(m_block + entries[i].offset);
+        }
+    }
+    if (!m_overflow.empty()) {
+        auto const& latest = getFieldLayout(m_class)->entries;
+        for (size_t i = 0; i < m_overflow.size(); i++) {
+            if (auto field = m_overflow[i]) {
+                auto const& entry = latest[entries.size() + i];
+                entry.destructor(field);
+                operator delete(field, std::align_val_t(entry.align));
+            }
+        }
+    }
+}
+
+FieldArena* FieldArena::create(size_t classIndex) {
+    auto layout = getFieldLayout(classIndex);
+    auto align = std::max(alignof(FieldArena), layout->align);
+    auto headerSize = (sizeof(FieldArena) + layout->align - 1) & ~(layout->align - 1);
+
+    // a single allocation for the arena and every field that's known of
+    auto memory = static_cast<std::byte*>(operator new(headerSize + layout->size, std::align_val_t(align)));
+    return new (memory) FieldArena(classIndex, layout, memory + headerSize);
+}
+
+void FieldArena::destroy(FieldArena* arena) {
+    auto align = std::max(alignof(FieldArena), arena->m_layout->align);
+    arena->~FieldArena();
+    operator delete(arena, std::align_val_t(align));
+}
+
+void* FieldArena::getOverflowField(size_t index) {
+    auto overflowIndex = index - m_layout->entries.size();
+    return overflowIndex < m_overflow.size() ? m_overflow[overflowIndex] : nullptr;
+}
+
+void* FieldArena::setOverflowField(size_t index) {
+    auto overflowIndex = index - m_layout->entries.size();
+    if (m_overflow.size() <= overflowIndex) {
+        m_overflow.resize(overflowIndex + 1, nullptr);
+    }
+    auto const& entry = getFieldLayout(m_class)->entries.at(index);
+    m_overflow[overflowIndex] = operator new(entry.size, std::align_val_t(entry.align));
+    return m_overflow[overflowIndex];
 }
 
 FieldContainer* CCNode::getFieldContainer(char const* forClass) {
-    return GeodeNodeMetadata::set(this)->getFieldContainer(forClass);
+    return GeodeNodeMetadata::set(this)->getLegacyFieldContainer(getFieldClassIndex(forClass));
+}
+
+FieldArena* CCNode::getFieldArena(size_t classIndex) {
+    return GeodeNodeMetadata::set(this)->getFieldArena(classIndex);
 }
 
 ZStringView CCNode::getID() {
-    return GeodeNodeMetadata::set(this)->m_id;
+    auto meta = GeodeNodeMetadata::get(this);
+    return meta ? ZStringView(meta->m_id) : ZStringView();
 }
 
 void CCNode::setID(std::string id) {
-    GeodeNodeMetadata::set(this)->m_id = std::move(id);
+    // clearing an ID that was never set shouldn't attach metadata
+    if (id.empty() && !GeodeNodeMetadata::get(this)) return;
+    auto meta = GeodeNodeMetadata::set(this);
+    forEachIDIndex(m_pParent, [&](IDIndex& index) {
+        index.remove(meta->m_id, this);
+        index.add(id, this);
+    });
+    meta->m_id = std::move(id);
+}
+
+void CCNode::setIDIndexEnabled(bool enabled) {
+    if (enabled == (getIDIndex(this) != nullptr)) return;
+
+    auto& extras = GeodeNodeMetadata::set(this)->extras();
+    if (enabled) {
+        extras.idIndex = std::make_unique<IDIndex>();
+        for (auto child : CCArrayExt<CCNode*>(m_pChildren)) {
+            extras.idIndex->addTree(child);
+        }
+    }
+    else {
+        extras.idIndex.reset();
+    }
+    markUnderIDIndex(this, m_pParent && isUnderIDIndex(m_pParent));
+}
+
+bool CCNode::isIDIndexEnabled() {
+    return getIDIndex(this) != nullptr;
+}
+
+// A node found through an index, with the position of each node leading from
+// the child of the searched node down to it in its parent's children. The
+// positions give the tree order of the matches without looking at the tree again
+struct IndexedMatch {
+    CCNode* node;
+    std::vector<unsigned int> path;
+};
+
+// The path from the node down to the descendant, or nullopt if it isn't a
+// descendant of the node (anymore)
+static std::optional<std::vector<unsigned int>> getChildPath(CCNode* node, CCNode* descendant) {
+    std::vector<unsigned int> path;
+    for (auto current = descendant; current != node; current = current->getParent()) {
+        auto parent = current->getParent();
+        if (!parent) return std::nullopt;
+        path.push_back(parent->getChildren()->indexOfObject(current));
+    }
+    std::reverse(path.begin(), path.end());
+    return path;
+}
+
+// The nodes with the ID under the node according to the nearest index. nullopt
+// if neither the node nor its ancestors have an index
+static std::optional<std::vector<IndexedMatch>> findIndexed(CCNode* node, std::string_view id) {
+    if (!isUnderIDIndex(node)) return std::nullopt;
+    for (auto current = node; current; current = current->getParent()) {
+        if (auto index = getIDIndex(current)) {
+            std::vector<IndexedMatch> found;
+            for (auto const& entry : index->find(id)) {
+                auto candidate = entry.lock();
+                if (!candidate || candidate == node) continue;
+                if (auto path = getChildPath(node, candidate)) {
+                    found.push_back({ candidate, std::move(*path) });
+                }
+            }
+            return found;
+        }
+    }
+    return std::nullopt;
 }
 
 CCNode* CCNode::getChildByID(std::string_view id) {
@@ -201,6 +583,26 @@ CCNode* CCNode::getChildByID(std::string_view id) {
 }
 
 CCNode* CCNode::getChildByIDRecursive(std::string_view id) {
+    if (auto found = findIndexed(this, id)) {
+        // pick the node the search below would have found first: direct
+        // children of a node are checked before going into any of them
+        auto first = std::min_element(found->begin(), found->end(), [](auto const& ma, auto const& mb) {
+            auto const& a = ma.path;
+            auto const& b = mb.path;
+            for (size_t i = 0;; i++) {
+                bool aHere = a.size() == i + 1, bHere = b.size() == i + 1;
+                if (a[i] == b[i]) {
+                    // one of them is an ancestor of the other
+                    if (aHere || bHere) return aHere;
+                    continue;
+                }
+                if (aHere != bHere) return aHere;
+                return a[i] < b[i];
+            }
+        });
+        return first != found->end() ? first->node : nullptr;
+    }
+
     if (auto child = this->getChildByID(id)) {
         return child;
     }
@@ -249,31 +651,33 @@ public:
     }
 };
 
-class NodeQuery final {
+// A parsed querySelector query, flattened into the list of IDs to match and
+// how each one relates to the previous one (or to the queried node)
+class CompiledQuery final {
 private:
     enum class Op {
         ImmediateChild,
         DescendantChild,
     };
 
-    std::string m_targetID;
-    Op m_nextOp;
-    std::unique_ptr<NodeQuery> m_next = nullptr;
+    struct Step {
+        Op op;
+        std::string id;
+    };
 
-public:
-    static Result<std::unique_ptr<NodeQuery>> parse(std::string_view query) {
+    std::vector<Step> m_steps;
+
+    static Result<CompiledQuery> parse(std::string_view query) {
         if (query.empty()) {
             return Err("Query may not be empty");
         }
 
-        auto result = std::make_unique<NodeQuery>();
-        NodeQuery* current = result.get();
-
-        size_t i = 0;
+        CompiledQuery result;
         std::string collectedID;
+        Op currentOp = Op::DescendantChild;
         std::optional<Op> nextOp = Op::DescendantChild;
-        while (i < query.size()) {
-            auto c = query.at(i);
+        for (size_t i = 0; i < query.size(); i += 1) {
+            auto c = query[i];
             if (c == ' ') {
                 if (!nextOp) {
                     nextOp.emplace(Op::DescendantChild);
@@ -291,12 +695,11 @@ public:
             // ID-valid characters
             else if (std::isalnum(c) || c == '-' || c == '_' || c == '/' || c == '.') {
                 if (nextOp) {
-                    current->m_next = std::make_unique<NodeQuery>();
-                    current->m_nextOp = *nextOp;
-                    current->m_targetID = collectedID;
-                    current = current->m_next.get();
-
-                    collectedID = "";
+                    if (!collectedID.empty()) {
+                        result.m_steps.push_back({ currentOp, std::move(collectedID) });
+                        collectedID.clear();
+                    }
+                    currentOp = *nextOp;
                     nextOp = std::nullopt;
                 }
                 collectedID.push_back(c);
@@ -306,39 +709,56 @@ public:
             else {
                 return Err("Unexpected character '{}' at index {}", c, i);
             }
-            i += 1;
         }
         if (nextOp || collectedID.empty()) {
             return Err("Expected node ID but got end of query");
         }
-        current->m_targetID = collectedID;
+        result.m_steps.push_back({ currentOp, std::move(collectedID) });
 
         return Ok(std::move(result));
     }
 
-    CCNode* match(CCNode* node) const {
-        // Make sure this matches the ID being looked for
-        if (!m_targetID.empty() && node->getID() != m_targetID) {
-            return nullptr;
-        }
-        // If this is the last thing to match, return the result
-        if (!m_next) {
+    // Left to right, returns the first node that matches the rest of the
+    // query from `step` onwards under `node`
+    CCNode* matchFrom(CCNode* node, size_t step) const {
+        if (step == m_steps.size()) {
             return node;
         }
-        switch (m_nextOp) {
+        auto const& [op, id] = m_steps[step];
+        switch (op) {
             case Op::ImmediateChild: {
                 for (auto c : CCArrayExt<CCNode*>(node->getChildren())) {
-                    if (auto r = m_next->match(c)) {
-                        return r;
+                    if (c->getID() == id) {
+                        if (auto r = this->matchFrom(c, step + 1)) {
+                            return r;
+                        }
                     }
                 }
             } break;
 
             case Op::DescendantChild: {
+                if (auto found = findIndexed(node, id)) {
+                    // same order as the crawler, shallowest first
+                    std::sort(found->begin(), found->end(), [](auto const& a, auto const& b) {
+                        if (a.path.size() != b.path.size()) {
+                            return a.path.size() < b.path.size();
+                        }
+                        return a.path < b.path;
+                    });
+                    for (auto const& match : *found) {
+                        if (auto r = this->matchFrom(match.node, step + 1)) {
+                            return r;
+                        }
+                    }
+                    return nullptr;
+                }
+
                 auto crawler = BFSNodeTreeCrawler(node);
                 while (auto c = crawler.next()) {
-                    if (auto r = m_next->match(c)) {
-                        return r;
+                    if (c->getID() == id) {
+                        if (auto r = this->matchFrom(c, step + 1)) {
+                            return r;
+                        }
                     }
                 }
             } break;
@@ -346,28 +766,140 @@ public:
         return nullptr;
     }
 
-    std::string toString() const {
-        auto str = m_targetID.empty() ? "&" : m_targetID;
-        if (m_next) {
-            switch (m_nextOp) {
-                case Op::ImmediateChild: str += " > "; break;
-                case Op::DescendantChild: str += " "; break;
+    // Right to left, whether `node` is matched by the query up to `step`,
+    // with the first step being relative to `root`
+    bool matchesAt(CCNode* root, CCNode* node, size_t step) const {
+        auto const& [op, id] = m_steps[step];
+        if (node == root || node->getID() != id) {
+            return false;
+        }
+        auto parent = node->getParent();
+        if (step == 0) {
+            if (op == Op::ImmediateChild) {
+                return parent == root;
+            }
+            for (auto ancestor = parent; ancestor; ancestor = ancestor->getParent()) {
+                if (ancestor == root) {
+                    return true;
+                }
+            }
+            return false;
+        }
+        if (op == Op::ImmediateChild) {
+            return parent && this->matchesAt(root, parent, step - 1);
+        }
+        for (auto ancestor = parent; ancestor && ancestor != root; ancestor = ancestor->getParent()) {
+            if (this->matchesAt(root, ancestor, step - 1)) {
+                return true;
             }
-            str += m_next->toString();
         }
-        return str;
+        return false;
+    }
+
+public:
+    // Parsing is cached by the query string, as the same handful of queries
+    // tend to get run over and over. Main thread only
+    static Result<std::shared_ptr<CompiledQuery const>> get(std::string_view query) {
+        struct Entry {
+            std::shared_ptr<CompiledQuery const> query;
+            std::string error;
+        };
+        static StringMap<Entry> cache;
+
+        auto it = cache.find(query);
+        if (it == cache.end()) {
+            // queries built at runtime could otherwise grow this forever
+            if (cache.size() >= 256) {
+                cache.clear();
+            }
+            Entry entry;
+            if (auto res = parse(query)) {
+                entry.query = std::make_shared<CompiledQuery const>(std::move(res).unwrap());
+            }
+            else {
+                entry.error = std::move(res).unwrapErr();
+            }
+            it = cache.emplace(std::string(query), std::move(entry)).first;
+        }
+        if (!it->second.query) {
+            return Err(it->second.error);
+        }
+        return Ok(it->second.query);
+    }
+
+    CCNode* match(CCNode* root) const {
+        return this->matchFrom(root, 0);
+    }
+
+    bool matches(CCNode* root, CCNode* node) const {
+        return this->matchesAt(root, node, m_steps.size() - 1);
+    }
+
+    std::string_view lastID() const {
+        return m_steps.back().id;
     }
 };
 
 CCNode* CCNode::querySelector(std::string_view queryStr) {
-    auto res = NodeQuery::parse(queryStr);
+    auto res = CompiledQuery::get(queryStr);
     if (!res) {
         log::error("Invalid CCNode::querySelector query '{}': {}", queryStr, res.unwrapErr());
         return nullptr;
     }
-    auto query = std::move(res.unwrap());
-    // log::info("parsed query: {}", query->toString());
-    return query->match(this);
+    return res.unwrap()->match(this);
+}
+
+// Candidates for the last ID of the query are checked against the rest of it
+// by walking up their parents, so that every match is only yielded once
+static utils::coro::Generator<CCNode*> querySelectorAllImpl(
+    Ref<CCNode> root, std::shared_ptr<CompiledQuery const> query
+) {
+    if (!query) {
+        co_return;
+    }
+    auto id = query->lastID();
+    if (isUnderIDIndex(root.data())) {
+        for (auto current = root.data(); current; current = current->getParent()) {
+            if (auto index = getIDIndex(current)) {
+                // the list is fetched again every time as the caller may
+                // change IDs in between
+                for (size_t i = 0; i < index->find(id).size(); i += 1) {
+                    auto node = index->find(id)[i].lock();
+                    if (node && query->matches(root, node)) {
+                        co_yield node.data();
+                    }
+                }
+                co_return;
+            }
+        }
+    }
+
+    // tree order, depth-first
+    std::vector<std::pair<CCNode*, unsigned int>> stack;
+    stack.emplace_back(root.data(), 0);
+    while (!stack.empty()) {
+        auto& [node, next] = stack.back();
+        auto children = node->getChildren();
+        if (!children || next >= children->count()) {
+            stack.pop_back();
+            continue;
+        }
+        auto child = static_cast<CCNode*>(children->objectAtIndex(next));
+        next += 1;
+        if (query->matches(root, child)) {
+            co_yield child;
+        }
+        stack.emplace_back(child, 0);
+    }
+}
+
+utils::coro::Generator<CCNode*> CCNode::querySelectorAll(std::string_view queryStr) {
+    auto res = CompiledQuery::get(queryStr);
+    if (!res) {
+        log::error("Invalid CCNode::querySelectorAll query '{}': {}", queryStr, res.unwrapErr());
+        return querySelectorAllImpl(this, nullptr);
+    }
+    return querySelectorAllImpl(this, std::move(res).unwrap());
 }
 
 void CCNode::removeChildByID(std::string_view id) {
@@ -390,7 +922,8 @@ void CCNode::setLayout(Layout* layout, bool apply, bool respectAnchor) {
 }
 
 Layout* CCNode::getLayout() {
-    return GeodeNodeMetadata::set(this)->m_layout.data();
+    auto meta = GeodeNodeMetadata::get(this);
+    return meta ? meta->m_layout.data() : nullptr;
 }
 
 void CCNode::setLayoutOptions(LayoutOptions* options, bool apply) {
@@ -401,14 +934,15 @@ void CCNode::setLayoutOptions(LayoutOptions* options, bool apply) {
 }
 
 LayoutOptions* CCNode::getLayoutOptions() {
-    return GeodeNodeMetadata::set(this)->m_layoutOptions.data();
+    auto meta = GeodeNodeMetadata::get(this);
+    return meta ? meta->m_layoutOptions.data() : nullptr;
 }
 
 void CCNode::updateLayout(bool updateChildOrder) {
     if (updateChildOrder && m_pChildren) {
         this->sortAllChildren();
     }
-    if (auto layout = GeodeNodeMetadata::set(this)->m_layout.data()) {
+    if (auto layout = this->getLayout()) {
         layout->apply(this);
     }
 }
@@ -419,7 +953,11 @@ void CCNode::setUserObject(std::string id, CCObject* value) {
 }
 
 CCObject* CCNode::getUserObject(std::string_view id) {
-    return GeodeNodeMetadata::set(this)->getUserObject(id);
+    if (auto meta = GeodeNodeMetadata::get(this)) {
+        return meta->getUserObject(id);
+    }
+    // without metadata, the default user object is still in its original place
+    return id.empty() ? m_pUserObject : nullptr;
 }
 
 void CCNode::setUserFlag(std::string id, bool state) {
@@ -427,7 +965,8 @@ void CCNode::setUserFlag(std::string id, bool state) {
 }
 
 bool CCNode::getUserFlag(std::string_view id) {
-    return GeodeNodeMetadata::set(this)->getUserFlag(id);
+    auto meta = GeodeNodeMetadata::get(this);
+    return meta && meta->getUserFlag(id);
 }
 
 ListenerHandle* CCNode::addEventListenerInternal(std::string id, ListenerHandle handle) {
@@ -435,19 +974,25 @@ ListenerHandle* CCNode::addEventListenerInternal(std::string id, ListenerHandle
 }
 
 void CCNode::removeEventListener(ListenerHandle* handle) {
-    GeodeNodeMetadata::set(this)->removeEventListener(handle);
+    if (auto meta = GeodeNodeMetadata::get(this)) {
+        meta->removeEventListener(handle);
+    }
 }
 
 void CCNode::removeEventListener(std::string_view id) {
-    GeodeNodeMetadata::set(this)->removeEventListener(id);
+    if (auto meta = GeodeNodeMetadata::get(this)) {
+        meta->removeEventListener(id);
+    }
 }
 
 ListenerHandle* CCNode::getEventListener(std::string_view id) {
-    return GeodeNodeMetadata::set(this)->getEventListener(id);
+    auto meta = GeodeNodeMetadata::get(this);
+    return meta ? meta->getEventListener(id) : nullptr;
 }
 
 size_t CCNode::getEventListenerCount() {
-    return GeodeNodeMetadata::set(this)->getEventListenerCount();
+    auto meta = GeodeNodeMetadata::get(this);
+    return meta ? meta->getEventListenerCount() : 0;
 }
 
 void CCNode::addChildAtPosition(CCNode* child, Anchor anchor, CCPoint const& offset, bool useAnchorLayout) {
@@ -64,6 +64,11 @@ struct CustomLoadingLayer : Modify<CustomLoadingLayer, LoadingLayer> {
 
         NodeIDs::provideFor(this);
 
+        // hash the resources while the mods are loading
+        if (!fromReload) {
+            (void)updater::verifyLoaderResourcesAsync();
+        }
+
         m_fields->m_totalMods = Loader::get()->getAllMods().size();
         m_fields->m_menuDisabled = Loader::get()->getLaunchFlag("disable-custom-menu");
         if (m_fields->m_menuDisabled) {
@@ -101,8 +106,17 @@ struct CustomLoadingLayer : Modify<CustomLoadingLayer, LoadingLayer> {
     void setupLoaderResources() {
         log::debug("Verifying Loader Resources");
         this->setSmallText("Verifying Geode Resources");
-        // verify loader resources
-        Loader::get()->queueInMainThread([&]() {
+        this->waitLoaderResources();
+    }
+
+    void waitLoaderResources() {
+        // verification happens on a worker thread, check back every frame until it's done
+        Loader::get()->queueInMainThread([this]() {
+            auto verification = updater::verifyLoaderResourcesAsync();
+            if (verification.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+                this->waitLoaderResources();
+                return;
+            }
             if (!updater::verifyLoaderResources()) {
                 log::debug("Downloading Loader Resources");
                 this->setSmallText("Downloading Geode Resources");
@@ -153,8 +167,21 @@ struct CustomLoadingLayer : Modify<CustomLoadingLayer, LoadingLayer> {
     void setupModResources() {
         log::debug("Loading mod resources");
         this->setSmallText("Loading mod resources");
-        LoaderImpl::get()->updateResources(true);
-        this->continueLoadAssets();
+        LoaderImpl::get()->updateResources(true, true);
+        this->waitModResources();
+    }
+
+    void waitModResources() {
+        // spritesheets are decoded on worker threads, upload the finished ones
+        // every frame within the main thread's budget
+        Loader::get()->queueInMainThread([this]() {
+            auto deadline = std::chrono::steady_clock::now() + LoaderImpl::get()->getMainThreadBudget();
+            if (!LoaderImpl::get()->uploadSpritesheets(deadline)) {
+                this->waitModResources();
+                return;
+            }
+            this->continueLoadAssets();
+        });
     }
 
     int getLoadedMods() {
@@ -1,4 +1,5 @@
 #include <Geode/loader/Loader.hpp>
+#include <Geode/utils/trace.hpp>
 
 using namespace geode::prelude;
 
@@ -9,6 +10,7 @@ namespace {
     void saveModData() {
         log::info("Saving mod data...");
         log::NestScope nest;
+        trace::Span span("Saving mod data");
 
         auto begin = std::chrono::high_resolution_clock::now();
 
@@ -1,15 +1,20 @@
 #include <loader/LoaderImpl.hpp>
 #include <loader/console.hpp>
+#include <loader/EventImpl.hpp>
 #include <loader/IPC.hpp>
 #include <loader/updater.hpp>
 
+#include <Geode/loader/Dirs.hpp>
+#include <Geode/loader/GameEvent.hpp>
 #include <Geode/loader/IPC.hpp>
 #include <Geode/loader/Loader.hpp>
 #include <Geode/loader/Log.hpp>
 #include <Geode/loader/Mod.hpp>
 #include <Geode/utils/JsonValidation.hpp>
 #include <Geode/utils/async.hpp>
+#include <Geode/utils/trace.hpp>
 #include <loader/LogImpl.hpp>
+#include <utils/trace.hpp>
 
 #include "internal/about.hpp"
 
@@ -49,6 +54,18 @@ $on_mod(Loaded) {
     });
 }
 
+$on_game(Loaded) {
+    if (!trace::isEnabled()) return;
+
+    auto path = dirs::getGeodeLogDir() / "startup-trace.json";
+    if (auto res = trace::exportTo(path); !res) {
+        log::warn("Unable to write startup trace: {}", res.unwrapErr());
+    }
+    else {
+        log::info("Wrote startup trace to {}", path);
+    }
+}
+
 void tryLogForwardCompat() {
     if (!LoaderImpl::get()->isForwardCompatMode()) return;
     // TODO: change text later
@@ -108,6 +125,7 @@ bool safeModeCheck() {
 
 int geodeEntry(void* platformData) {
     thread::setName("Main");
+    comm::markLoadingEventThread();
 
     console::setup();
     if (LoaderImpl::get()->isForwardCompatMode()) {
@@ -198,7 +216,7 @@ int geodeEntry(void* platformData) {
     // 0 means no deletion
     if (logMaxAge > 0) {
         // put it in a task so that it doesn't slow down launch times
-        async::runtime().spawnBlocking<void>([logMaxAge] {
+        async::spawnBlocking(async::BlockingLane::IO, [logMaxAge] {
             log::Logger::get()->deleteOldLogs(std::chrono::days{logMaxAge});
         });
     }
@@ -1,12 +1,36 @@
-#include <Geode/loader/Event.hpp>
+#include "EventImpl.hpp"
+#include <Geode/loader/Loader.hpp>
 #include <Geode/utils/ranges.hpp>
 #include <mutex>
+#include <unordered_map>
 
 using namespace geode::prelude;
 using namespace geode::comm;
 
+static std::vector<PortObserver>& portObservers() {
+    static std::vector<PortObserver> s_observers;
+    return s_observers;
+}
+
+void geode::comm::addPortObserver(PortObserver observer) {
+    portObservers().push_back(std::move(observer));
+}
+
+static void notifyPortObservers(BaseFilter const* filter, bool added) {
+    for (auto& observer : portObservers()) {
+        observer(filter, added);
+    }
+}
+
 // EventCenterThreadLocal
 
+// every center that processes posted functions, by the thread that does it
+static std::mutex s_threadCentersMutex;
+static std::unordered_map<std::thread::id, EventCenterThreadLocal*> s_threadCenters;
+
+static std::atomic<std::thread::id> s_mainEventThread;
+static std::atomic_bool s_mainEventThreadTicked = false;
+
 class EventCenterThreadLocal::Impl {
 public:
     using KeyType = std::shared_ptr<BaseFilter>;
@@ -14,15 +38,130 @@ public:
     using MapType = std::unordered_map<KeyType, ValueType, BaseFilterHash, BaseFilterEqual>;
 
     MapType m_ports;
+    size_t m_generation = 0;
+
+    std::mutex m_postedMutex;
+    std::vector<PostFuncType> m_posted;
+    std::atomic_bool m_hasPosted = false;
+
+    // leaked on purpose, since its listeners may belong to mods that are
+    // already gone by the time static destructors run
+    static EventCenterThreadLocal* shared() {
+        static auto s_instance = new EventCenterThreadLocal();
+        return s_instance;
+    }
+
+    // the center of a thread that opted into its own
+    struct OwnCenter {
+        EventCenterThreadLocal* center = nullptr;
+        // whether a thread using the shared center was checked to be the main thread
+        bool checked = false;
+
+        ~OwnCenter() {
+            if (!center) return;
+            {
+                std::lock_guard lock(s_threadCentersMutex);
+                s_threadCenters.erase(std::this_thread::get_id());
+            }
+            delete center;
+        }
+    };
+    static thread_local OwnCenter s_ownCenter;
 };
 
+thread_local EventCenterThreadLocal::Impl::OwnCenter EventCenterThreadLocal::Impl::s_ownCenter;
+
 EventCenterThreadLocal::EventCenterThreadLocal() : m_impl(std::make_unique<Impl>()) {}
 EventCenterThreadLocal::~EventCenterThreadLocal() = default;
 
+static void setMainEventThread() {
+    auto previous = s_mainEventThread.exchange(std::this_thread::get_id());
+    std::lock_guard lock(s_threadCentersMutex);
+    // the thread that loaded mods hands the shared center over
+    if (auto it = s_threadCenters.find(previous); it != s_threadCenters.end() && it->second == EventCenterThreadLocal::get()) {
+        s_threadCenters.erase(it);
+    }
+    s_threadCenters.try_emplace(std::this_thread::get_id(), EventCenterThreadLocal::get());
+}
+
+void geode::comm::markLoadingEventThread() {
+    setMainEventThread();
+}
+
+void geode::comm::markMainEventThread() {
+    setMainEventThread();
+    s_mainEventThreadTicked = true;
+}
+
+bool geode::comm::isMainEventThread() {
+    return s_mainEventThread.load() == std::this_thread::get_id();
+}
+
 EventCenterThreadLocal* EventCenterThreadLocal::get() {
-    // TODO: make this back threadlocal
-    static auto s_instance = new EventCenterThreadLocal();
-    return s_instance;
+    auto& own = Impl::s_ownCenter;
+    if (own.center) {
+        return own.center;
+    }
+    // The shared center is not synchronized, so any other thread using it races
+    // with the main thread. Say so once per thread instead of failing silently.
+    // Before the first tick the main thread isn't known for sure on every platform
+    if (!own.checked && s_mainEventThreadTicked.load(std::memory_order_relaxed)) {
+        own.checked = true;
+        if (!isMainEventThread()) {
+            log::error(
+                "Non thread safe events were used off the main thread without an "
+                "event center of its own. Use thread safe events there, or call "
+                "EventCenterThreadLocal::useOwnForCurrentThread on that thread first"
+            );
+        }
+    }
+    return Impl::shared();
+}
+
+void EventCenterThreadLocal::useOwnForCurrentThread() {
+    if (Impl::s_ownCenter.center) return;
+    auto center = new EventCenterThreadLocal();
+    {
+        std::lock_guard lock(s_threadCentersMutex);
+        s_threadCenters[std::this_thread::get_id()] = center;
+    }
+    Impl::s_ownCenter.center = center;
+}
+
+bool EventCenterThreadLocal::isProcessedOnCurrentThread() noexcept {
+    return Impl::s_ownCenter.center || isMainEventThread();
+}
+
+bool EventCenterThreadLocal::postTo(std::thread::id thread, PostFuncType func) noexcept {
+    // holding this also keeps the target center from being destroyed
+    std::lock_guard lock(s_threadCentersMutex);
+    auto it = s_threadCenters.find(thread);
+    if (it == s_threadCenters.end()) {
+        return false;
+    }
+    auto impl = it->second->m_impl.get();
+    std::lock_guard postedLock(impl->m_postedMutex);
+    impl->m_posted.push_back(std::move(func));
+    impl->m_hasPosted = true;
+    return true;
+}
+
+void EventCenterThreadLocal::postToMain(PostFuncType func) noexcept {
+    queueInMainThread(std::move(func));
+}
+
+void EventCenterThreadLocal::processPosted() noexcept {
+    if (!m_impl->m_hasPosted.exchange(false)) {
+        return;
+    }
+    std::vector<PostFuncType> posted;
+    {
+        std::lock_guard lock(m_impl->m_postedMutex);
+        posted.swap(m_impl->m_posted);
+    }
+    for (auto& func : posted) {
+        func();
+    }
 }
 
 bool EventCenterThreadLocal::send(BaseFilter const* filter, SendFuncType func, MigrateFuncType migratePort) noexcept {
@@ -34,6 +173,7 @@ bool EventCenterThreadLocal::send(BaseFilter const* filter, SendFuncType func, M
         // log::debug("found port for filter {}", (void*)it->first.get());
         if (auto newPort = std::invoke(migratePort, it->second.get())) {
             it->second.reset(newPort);
+            m_impl->m_generation++;
         }
 
         auto port = it->second;
@@ -58,6 +198,7 @@ ListenerHandle EventCenterThreadLocal::addReceiver(BaseFilter const* filter, Add
     if (it != m_impl->m_ports.end()) {
         if (auto newPort = std::invoke(migratePort, it->second.get())) {
             it->second.reset(newPort);
+            m_impl->m_generation++;
         }
         return ListenerHandle(it->first, std::invoke(func, it->second.get()), nullptr);
     }
@@ -79,7 +220,11 @@ ListenerHandle EventCenterThreadLocal::addReceiver(BaseFilter const* filter, Add
         // }
         auto ret = ListenerHandle(clonedFilter, handle, nullptr);
 
+        if (this == Impl::shared()) {
+            notifyPortObservers(clonedFilter.get(), true);
+        }
         m_impl->m_ports.emplace(std::move(clonedFilter), std::move(port));
+        m_impl->m_generation++;
 
         auto it2 = m_impl->m_ports.find(filter);
     //     if (std::string(cast::getRuntimeTypeName(filter)).find("UpdateModListStateEvent") != std::string::npos) {
@@ -98,6 +243,7 @@ size_t EventCenterThreadLocal::getReceiverCount(BaseFilter const* filter, SizeFu
     if (it != m_impl->m_ports.end()) {
         if (auto newPort = std::invoke(migratePort, it->second.get())) {
             it->second.reset(newPort);
+            m_impl->m_generation++;
         }
         return std::invoke(func, it->second.get());
     }
@@ -111,11 +257,16 @@ size_t EventCenterThreadLocal::removeReceiver(BaseFilter const* filter, RemoveFu
     if (it != m_impl->m_ports.end()) {
         if (auto newPort = std::invoke(migratePort, it->second.get())) {
             it->second.reset(newPort);
+            m_impl->m_generation++;
         }
         auto size = std::invoke(func, it->second.get());
         if (size == 0) {
             // geode::console::log(fmt::format("Removing port for filter type {}", cast::getRuntimeTypeName(filter)), Severity::Debug);
+            if (this == Impl::shared()) {
+                notifyPortObservers(it->first.get(), false);
+            }
             m_impl->m_ports.erase(it);
+            m_impl->m_generation++;
         }
 
         // if (std::string(cast::getRuntimeTypeName(filter)).find("UpdateModListStateEvent") != std::string::npos) {
@@ -126,8 +277,31 @@ size_t EventCenterThreadLocal::removeReceiver(BaseFilter const* filter, RemoveFu
     return (size_t)-1;
 }
 
+size_t EventCenterThreadLocal::getGeneration() const noexcept {
+    return m_impl->m_generation;
+}
+ResolvedPort EventCenterThreadLocal::resolvePort(BaseFilter const* filter, MigrateFuncType migratePort) noexcept {
+    auto it = m_impl->m_ports.find(filter);
+    if (it != m_impl->m_ports.end()) {
+        if (auto newPort = std::invoke(migratePort, it->second.get())) {
+            it->second.reset(newPort);
+            m_impl->m_generation++;
+        }
+        return ResolvedPort{it->second, m_impl->m_generation};
+    }
+    return ResolvedPort{nullptr, m_impl->m_generation};
+}
+
 // EventCenterGlobal
 
+// Mods built with older headers add and remove receivers with their own inline
+// code, which only updates the members those headers know about
+static void syncLegacyPort(OpaquePortBase* port) {
+    if (auto sync = typeinfo_cast<LegacyPortSync*>(port)) {
+        sync->syncLegacy();
+    }
+}
+
 class EventCenterGlobal::Impl {
 public:
     using KeyType = std::shared_ptr<BaseFilter>;
@@ -136,6 +310,7 @@ public:
 
     std::mutex m_mutex;
     MapType m_ports;
+    std::atomic_size_t m_generation = 0;
 };
 
 EventCenterGlobal::EventCenterGlobal() : m_impl(std::make_unique<Impl>()) {}
@@ -156,6 +331,7 @@ bool EventCenterGlobal::send(BaseFilter const* filter, SendFuncType func, Migrat
     if (it != end) {
         if (auto newPort = std::invoke(migratePort, it->second.get())) {
             it->second.reset(newPort);
+            m_impl->m_generation++;
         }
 
         auto port = it->second;
@@ -174,8 +350,11 @@ ListenerHandle EventCenterGlobal::addReceiver(BaseFilter const* filter, AddFuncT
     if (it != end) {
         if (auto newPort = std::invoke(migratePort, it->second.get())) {
             it->second.reset(newPort);
+            m_impl->m_generation++;
         }
-        return ListenerHandle(it->first, std::invoke(func, it->second.get()), nullptr);
+        auto handle = std::invoke(func, it->second.get());
+        syncLegacyPort(it->second.get());
+        return ListenerHandle(it->first, handle, nullptr);
     }
     else {
         auto clonedFilter = Impl::KeyType(filter->clone());
@@ -187,9 +366,12 @@ ListenerHandle EventCenterGlobal::addReceiver(BaseFilter const* filter, AddFuncT
         if (!port) return ListenerHandle();
 
         ReceiverHandle handle = std::invoke(func, port.get());
+        syncLegacyPort(port.get());
         auto ret = ListenerHandle(clonedFilter, handle, nullptr);
 
+        notifyPortObservers(clonedFilter.get(), true);
         m_impl->m_ports.emplace(std::move(clonedFilter), std::move(port));
+        m_impl->m_generation++;
         return ret;
     }
 }
@@ -201,6 +383,7 @@ size_t EventCenterGlobal::getReceiverCount(BaseFilter const* filter, SizeFuncTyp
     if (it != end) {
         if (auto newPort = std::invoke(migratePort, it->second.get())) {
             it->second.reset(newPort);
+            m_impl->m_generation++;
         }
 
         auto port = it->second;
@@ -219,13 +402,34 @@ size_t EventCenterGlobal::removeReceiver(BaseFilter const* filter, RemoveFuncTyp
     if (it != end) {
         if (auto newPort = std::invoke(migratePort, it->second.get())) {
             it->second.reset(newPort);
+            m_impl->m_generation++;
         }
         auto size = std::invoke(func, it->second.get());
+        syncLegacyPort(it->second.get());
         if (size == 0) {
             // geode::console::log(fmt::format("Removing port for filter type {}", cast::getRuntimeTypeName(filter)), Severity::Debug);
+            notifyPortObservers(it->first.get(), false);
             m_impl->m_ports.erase(it);
+            m_impl->m_generation++;
         }
         return size;
     }
     return (size_t)-1;
-}
\ No newline at end of file
+}
+size_t EventCenterGlobal::getGeneration() const noexcept {
+    return m_impl->m_generation.load(std::memory_order_acquire);
+}
+ResolvedPort EventCenterGlobal::resolvePort(BaseFilter const* filter, MigrateFuncType migratePort) noexcept {
+    auto lock = std::unique_lock<std::mutex>(m_impl->m_mutex);
+    auto it = m_impl->m_ports.find(filter);
+    auto const end = m_impl->m_ports.end();
+
+    if (it != end) {
+        if (auto newPort = std::invoke(migratePort, it->second.get())) {
+            it->second.reset(newPort);
+            m_impl->m_generation++;
+        }
+        return ResolvedPort{it->second, m_impl->m_generation};
+    }
+    return ResolvedPort{nullptr, m_impl->m_generation};
+}
@@ -0,0 +1,22 @@
+#pragma once
+
+#include <Geode/loader/Event.hpp>
+
+namespace geode::comm {
+    // Called by the global and the shared thread local event center whenever
+    // they create (added = true) or erase the port for a filter. This lets the loader keep track of
+    // whether anyone listens to its hot events without looking them up.
+    // Observers must be added before any listeners are, and must be cheap
+    // since the global event center calls them with its lock held.
+    using PortObserver = geode::Function<void(BaseFilter const* filter, bool added)>;
+
+    void addPortObserver(PortObserver observer);
+
+    // Called by the loader's entry point. The thread that loads mods counts as
+    // the main thread until the first main loop tick
+    void markLoadingEventThread();
+    // Called on the first main loop tick, which on some platforms runs on a
+    // different thread than the loader's entry point
+    void markMainEventThread();
+    bool isMainEventThread();
+}
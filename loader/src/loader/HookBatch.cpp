@@ -0,0 +1,92 @@
+#include <Geode/loader/Hook.hpp>
+#include "PatchImpl.hpp"
+
+#include <algorithm>
+#include <utility>
+
+using namespace geode::prelude;
+
+class HookBatch::Impl final {
+public:
+    std::vector<std::pair<Hook*, bool>> m_hooks;
+    std::vector<std::pair<Patch*, bool>> m_patches;
+};
+
+HookBatch::HookBatch() : m_impl(std::make_unique<Impl>()) {}
+HookBatch::~HookBatch() = default;
+HookBatch::HookBatch(HookBatch&& other) noexcept = default;
+HookBatch& HookBatch::operator=(HookBatch&& other) noexcept = default;
+
+HookBatch& HookBatch::enable(Hook* hook) {
+    m_impl->m_hooks.emplace_back(hook, true);
+    return *this;
+}
+
+HookBatch& HookBatch::disable(Hook* hook) {
+    m_impl->m_hooks.emplace_back(hook, false);
+    return *this;
+}
+
+HookBatch& HookBatch::enable(Patch* patch) {
+    m_impl->m_patches.emplace_back(patch, true);
+    return *this;
+}
+
+HookBatch& HookBatch::disable(Patch* patch) {
+    m_impl->m_patches.emplace_back(patch, false);
+    return *this;
+}
+
+Result<> HookBatch::commit() {
+    auto hooks = std::exchange(m_impl->m_hooks, {});
+    auto patches = std::exchange(m_impl->m_patches, {});
+
+    // the last request for the same patch wins, and patches that are already
+    // in the requested state are left alone
+    std::vector<Patch::Impl*> seenPatches, enablePatches, disablePatches;
+    for (auto it = patches.rbegin(); it != patches.rend(); ++it) {
+        auto impl = it->first->m_impl.get();
+        if (std::find(seenPatches.begin(), seenPatches.end(), impl) != seenPatches.end()) continue;
+        seenPatches.push_back(impl);
+        if (impl->isEnabled() == it->second) continue;
+        (it->second ? enablePatches : disablePatches).push_back(impl);
+    }
+    GEODE_UNWRAP(Patch::Impl::apply(enablePatches, disablePatches));
+
+    // same for hooks
+    std::vector<Hook*> seenHooks;
+    std::vector<std::pair<Hook*, bool>> toggles;
+    for (auto it = hooks.rbegin(); it != hooks.rend(); ++it) {
+        if (std::find(seenHooks.begin(), seenHooks.end(), it->first) != seenHooks.end()) continue;
+        seenHooks.push_back(it->first);
+        if (it->first->isEnabled() == it->second) continue;
+        toggles.push_back(*it);
+    }
+
+    // tulip writes each hook's trampoline jump itself, so the best that can be
+    // done for hooks is to install them in address order, which keeps
+    // consecutive writes on the same pages
+    std::stable_sort(toggles.begin(), toggles.end(), [](auto const& a, auto const& b) {
+        return a.first->getAddress() < b.first->getAddress();
+    });
+    std::vector<std::pair<Hook*, bool>> applied;
+    for (auto const& [hook, enable] : toggles) {
+        auto res = hook->toggle(enable);
+        if (!res) {
+            auto error = fmt::format("Failed to {} hook {}: {}", enable ? "enable" : "disable", hook->getDisplayName(), res.unwrapErr());
+            // undo everything in reverse
+            for (auto it = applied.rbegin(); it != applied.rend(); ++it) {
+                if (auto undo = it->first->toggle(!it->second); !undo) {
+                    error += fmt::format(", and failed to undo hook {}: {}", it->first->getDisplayName(), undo.unwrapErr());
+                }
+            }
+            if (auto undo = Patch::Impl::apply(disablePatches, enablePatches); !undo) {
+                error += fmt::format(", and failed to undo patches: {}", undo.unwrapErr());
+            }
+            return Err(std::move(error));
+        }
+        applied.emplace_back(hook, enable);
+    }
+
+    return Ok();
+}
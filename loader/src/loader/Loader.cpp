@@ -79,6 +79,22 @@ void Loader::queueInMainThread(ScheduledFunction&& func) {
     return m_impl->queueInMainThread(std::forward<ScheduledFunction>(func));
 }
 
+void Loader::queueInMainThread(ScheduledFunction&& func, MainThreadPriority priority) {
+    return m_impl->queueInMainThread(std::forward<ScheduledFunction>(func), priority);
+}
+
+void Loader::setMainThreadBudget(std::chrono::microseconds budget) {
+    return m_impl->setMainThreadBudget(budget);
+}
+
+std::chrono::microseconds Loader::getMainThreadBudget() const {
+    return m_impl->getMainThreadBudget();
+}
+
+MainThreadLaneMetrics Loader::getMainThreadLaneMetrics(MainThreadPriority priority) const {
+    return m_impl->getMainThreadLaneMetrics(priority);
+}
+
 std::string Loader::getGameVersion() {
     return m_impl->getGameVersion();
 }
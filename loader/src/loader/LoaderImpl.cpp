@@ -1,6 +1,7 @@
 #include "LoaderImpl.hpp"
 #include <cocos2d.h>
 
+#include "EventImpl.hpp"
 #include "ModImpl.hpp"
 #include "ModMetadataImpl.hpp"
 #include "LogImpl.hpp"
@@ -17,6 +18,7 @@
 #include <Geode/utils/map.hpp>
 #include <Geode/utils/ranges.hpp>
 #include <Geode/utils/string.hpp>
+#include <Geode/utils/trace.hpp>
 #include <Geode/utils/web.hpp>
 #include <about.hpp>
 #include <crashlog.hpp>
@@ -24,6 +26,7 @@
 #include <hash.hpp>
 #include <iostream>
 #include <iterator>
+#include <future>
 #include <optional>
 #include <resources.hpp>
 #include <string>
@@ -32,6 +35,7 @@
 #include <vector>
 
 #include <server/DownloadManager.hpp>
+#include <utils/trace.hpp>
 #include <Geode/ui/Popup.hpp>
 
 using namespace geode::prelude;
@@ -70,7 +74,7 @@ void Loader::Impl::removeDirectories() {
     log::debug("Removing unnecessary directories");
     // clean up of stale data from Geode v2
     if(std::filesystem::exists(dirs::getGeodeDir() / "index")) {
-        async::runtime().spawnBlocking<void>([] {
+        async::spawnBlocking(async::BlockingLane::IO, [] {
             std::error_code ec;
             std::filesystem::remove_all(dirs::getGeodeDir() / "index", ec);
         });
@@ -88,6 +92,11 @@ Result<> Loader::Impl::setup() {
         this->initLaunchArguments();
     }
 
+    if (this->getLaunchFlag("trace-startup")) {
+        log::info("Recording startup trace");
+        trace::enable();
+    }
+
     if (auto value = this->getLaunchArgument("use-common-handler-offset")) {
         log::info("Using common handler offset: {}", value.value());
         log::NestScope nest;
@@ -106,6 +115,16 @@ Result<> Loader::Impl::setup() {
         }
     }
 
+    if (auto value = this->getLaunchArgument("mod-load-budget")) {
+        auto budget = numFromString<int>(value.value());
+        if (budget.isErr() || budget.unwrap() < 0) {
+            log::error("Could not parse mod load budget, falling back to default");
+        } else {
+            log::info("Using mod load budget: {}ms", budget.unwrap());
+            m_modLoadBudget = std::chrono::milliseconds(budget.unwrap());
+        }
+    }
+
     if (auto value = this->getLaunchArgument("binary-dir")) {
         log::info("Using custom binary directory: {}", value.value());
         m_binaryPath = value.value();
@@ -167,7 +186,7 @@ void Loader::Impl::addSearchPaths() {
     CCFileUtils::get()->addPriorityPath(utils::string::pathToString(dirs::getModRuntimeDir()).c_str());
 }
 
-void Loader::Impl::updateResources(bool forceReload) {
+void Loader::Impl::updateResources(bool forceReload, bool deferUploads) {
     log::debug("Adding resources");
 
     log::NestScope nest;
@@ -183,6 +202,10 @@ void Loader::Impl::updateResources(bool forceReload) {
     // by default this will just end up calling `updateModResources` on each mod
     LoaderUpdateModResourcesEvent().send(mods);
 
+    if (!deferUploads) {
+        this->finishSpritesheets();
+    }
+
     for (auto mod : mods) {
         ModImpl::getImpl(mod)->m_resourcesLoaded = true;
     }
@@ -273,6 +296,8 @@ void Loader::Impl::updateModResources(Mod* mod) {
     // skip disabled mods
     if (!mod->isOrWillBeEnabled()) return;
 
+    trace::Span span("Registering resources", mod);
+
     if (!mod->isInternal()) {
         // geode.loader resource is stored somewhere else, which is already added anyway
         auto searchPathRoot = dirs::getModRuntimeDir() / mod->getID() / "resources";
@@ -286,6 +311,7 @@ void Loader::Impl::updateModResources(Mod* mod) {
 
     log::debug("{}", mod->getID());
     log::NestScope nest;
+    trace::Span sheetsSpan("Loading spritesheets", mod);
 
     for (auto const& sheet : sheets) {
         log::debug("Adding sheet {}", sheet);
@@ -310,12 +336,106 @@ void Loader::Impl::updateModResources(Mod* mod) {
             );
         }
         else {
-            CCTextureCache::get()->addImage(pngPath.c_str(), false);
-            CCSpriteFrameCache::get()->addSpriteFramesWithFile(plistPath.c_str());
+            this->loadSpritesheet(mod, std::move(pngPath), std::move(plistPath));
         }
     }
 }
 
+void Loader::Impl::loadSpritesheet(Mod* mod, std::string png, std::string plist) {
+    auto sheet = m_pendingSpritesheets.emplace_back(std::make_shared<PendingSpritesheet>());
+    sheet->mod = mod;
+    sheet->png = std::move(png);
+    sheet->plist = std::move(plist);
+
+    // textures that are still cached from before a reload don't need decoding again
+    bool decode = !CCTextureCache::get()->textureForKey(sheet->png.c_str());
+
+    async::spawnBlocking(async::BlockingLane::CPU, [sheet, decode] {
+        if (decode) {
+            trace::Span span("Decoding spritesheet", sheet->mod);
+            auto image = new CCImage();
+            if (image->initWithImageFileThreadSafe(sheet->png.c_str())) {
+                sheet->image = image;
+            }
+            else {
+                image->release();
+            }
+        }
+        {
+            trace::Span span("Reading spritesheet frames", sheet->mod);
+            auto frames = loadSpriteFrames(sheet->plist);
+            if (frames) {
+                sheet->frames = std::move(frames).unwrap();
+            }
+            else {
+                log::warn("Failed to read frames of {}: {}", sheet->plist, frames.unwrapErr());
+            }
+        }
+        sheet->decoded.store(true, std::memory_order::release);
+        sheet->decoded.notify_one();
+    });
+}
+
+void Loader::Impl::uploadSpritesheet(PendingSpritesheet& sheet) {
+    trace::Span span("Uploading spritesheet", sheet.mod);
+
+    auto textureCache = CCTextureCache::get();
+    if (sheet.image) {
+        auto texture = new CCTexture2D();
+        if (texture->initWithImage(sheet.image)) {
+#if CC_ENABLE_CACHE_TEXTURE_DATA
+            // like addImage, so the texture is reloaded when the GL context is lost
+            VolatileTexture::addImageTexture(texture, sheet.png.c_str(), CCImage::kFmtPng);
+#endif
+            textureCache->m_pTextures->setObject(texture, sheet.png.c_str());
+        }
+        else {
+            log::warn("Failed to create texture for {}", sheet.png);
+        }
+        texture->release();
+        sheet.image->release();
+        sheet.image = nullptr;
+    }
+
+    if (auto texture = textureCache->textureForKey(sheet.png.c_str())) {
+        if (sheet.frames) {
+            addSpriteFrames(*sheet.frames, texture);
+        }
+        else {
+            CCSpriteFrameCache::get()->addSpriteFramesWithFile(sheet.plist.c_str(), texture);
+        }
+    }
+    else {
+        // decoding failed, let cocos try (and log about it) the usual way
+        textureCache->addImage(sheet.png.c_str(), false);
+        CCSpriteFrameCache::get()->addSpriteFramesWithFile(sheet.plist.c_str());
+    }
+}
+
+bool Loader::Impl::uploadSpritesheets(std::chrono::steady_clock::time_point deadline) {
+    while (!m_pendingSpritesheets.empty()) {
+        auto& sheet = *m_pendingSpritesheets.front();
+        if (!sheet.decoded.load(std::memory_order::acquire)) {
+            return false;
+        }
+        this->uploadSpritesheet(sheet);
+        m_pendingSpritesheets.pop_front();
+        if (std::chrono::steady_clock::now() >= deadline) {
+            break;
+        }
+    }
+    return m_pendingSpritesheets.empty();
+}
+
+void Loader::Impl::finishSpritesheets() {
+    while (!m_pendingSpritesheets.empty()) {
+        auto& sheet = *m_pendingSpritesheets.front();
+        sheet.decoded.wait(false, std::memory_order::acquire);
+        this->uploadSpritesheet(sheet);
+        m_pendingSpritesheets.pop_front();
+    }
+}
+
 void Loader::Impl::addProblem(LoadProblem const& problem) {
     if (auto mod = std::get_if<Mod*>(&problem.cause)) {
         auto impl = ModImpl::getImpl(*mod);
@@ -335,42 +455,69 @@ void Loader::Impl::addProblem(LoadProblem const& problem) {
 // Dependencies and refreshing
 
 void Loader::Impl::queueMods(std::vector<ModMetadata>& modQueue) {
+    std::vector<std::filesystem::path> paths;
     for (auto const& dir : m_modSearchDirectories) {
         log::debug("Searching {}", dir);
-        log::NestScope nest;
         for (auto const& entry : std::filesystem::directory_iterator(dir)) {
             if (!std::filesystem::is_regular_file(entry) ||
                 entry.path().extension() != GEODE_MOD_EXTENSION)
                 continue;
+            paths.push_back(entry.path());
+        }
+    }
 
-            log::debug("Found {}", entry.path().filename());
-            log::NestScope nest;
-
-            auto modMetadata = ModMetadata::createFromGeodeFile(entry.path());
+    // reading the metadata means opening every package, so do that in parallel
+    // and skip the packages that have not changed since the last launch. This
+    // thread still waits for all of them, so this only shortens the wait.
+    // Parsing logs validation warnings, so it happens here in directory order
+    ModMetadataIndex index(dirs::getTempDir() / "mod-index.json");
+    std::vector<ModMetadata::Impl::GeodeFileContents> contents(paths.size());
+    std::atomic_size_t remaining = paths.size();
+    for (size_t i = 0; i < paths.size(); ++i) {
+        async::spawnBlocking(async::BlockingLane::IO, [&, i] {
+            contents[i] = ModMetadata::Impl::readGeodeFile(paths[i], &index);
+            if (remaining.fetch_sub(1, std::memory_order::acq_rel) == 1) {
+                remaining.notify_all();
+            }
+        });
+    }
+    for (auto left = remaining.load(std::memory_order::acquire); left != 0; left = remaining.load(std::memory_order::acquire)) {
+        remaining.wait(left, std::memory_order::acquire);
+    }
 
-            log::debug("id: {}", modMetadata.getID());
-            log::debug("version: {}", modMetadata.getVersion());
-            log::debug("early: {}", modMetadata.needsEarlyLoad() ? "yes" : "no");
+    // queue in directory order so duplicates resolve the same way every time
+    for (size_t i = 0; i < paths.size(); ++i) {
+        log::debug("Found {}", paths[i].filename());
+        log::NestScope nest;
 
-            if (std::find_if(modQueue.begin(), modQueue.end(), [&](auto& item) {
-                    return modMetadata.getID() == item.getID();
-                }) != modQueue.end()) {
-                log::error("Failed to queue: a mod with the same ID is already queued");
+        auto modMetadata = ModMetadata::Impl::createFromGeodeFile(paths[i], std::move(contents[i]), &index);
 
-                auto modMetadata = ModMetadataImpl::createInvalidMetadata(
-                    entry.path(),
-                    "A mod with the same ID is already present.",
-                    // Passing `nullopt` to `createInvalidMetadata` generates a
-                    // random non-conflicting ID
-                    std::nullopt
-                );
-                modQueue.push_back(modMetadata);
+        log::debug("id: {}", modMetadata.getID());
+        log::debug("version: {}", modMetadata.getVersion());
+        log::debug("early: {}", modMetadata.needsEarlyLoad() ? "yes" : "no");
 
-                continue;
-            }
+        if (std::find_if(modQueue.begin(), modQueue.end(), [&](auto& item) {
+                return modMetadata.getID() == item.getID();
+            }) != modQueue.end()) {
+            log::error("Failed to queue: a mod with the same ID is already queued");
 
+            auto modMetadata = ModMetadataImpl::createInvalidMetadata(
+                paths[i],
+                "A mod with the same ID is already present.",
+                // Passing `nullopt` to `createInvalidMetadata` generates a
+                // random non-conflicting ID
+                std::nullopt
+            );
             modQueue.push_back(modMetadata);
+
+            continue;
         }
+
+        modQueue.push_back(std::move(modMetadata));
+    }
+
+    if (auto res = index.save(); !res) {
+        log::warn("Unable to save mod index: {}", res.unwrapErr());
     }
 }
 
@@ -533,64 +680,137 @@ void Loader::Impl::loadModGraph(Mod* node, bool early) {
     m_refreshedModCount += 1;
     m_lateRefreshedModCount += early ? 0 : 1;
 
-    auto unzipFunction = [this, node]() {
-        log::debug("Unzipping .geode file");
-        auto res = this->unzipGeodeFile(node->getMetadata());
-        return res;
-    };
+    auto extraction = this->takeModExtraction(node);
 
-    auto loadFunction = [this, node, early]() {
-        if (node->shouldLoad()) {
-            log::debug("Loading binary");
-            auto res = node->m_impl->loadBinary();
-            if (!res) {
-                this->addProblem({
-                    LoadProblem::Type::Unknown,
-                    node,
-                    res.unwrapErr()
-                });
-                log::error("Failed to load binary: {}", res.unwrapErr());
-                m_refreshingModCount -= 1;
-                return;
-            }
-        }
+    if (early) {
+        // early mods have to be loaded right now, so just wait for the extraction
+        this->finishLoadModGraph(node, extraction.get());
+    }
+    else if (extraction.wait_for(std::chrono::seconds(0)) == std::future_status::ready) {
+        this->finishLoadModGraph(node, extraction.get());
+    }
+    else {
+        // continueRefreshModGraph polls this every frame until the extraction is done
+        m_pendingExtractions.push_back({ node, std::move(extraction), log::saveNest() });
+    }
+}
 
+void Loader::Impl::finishLoadModGraph(Mod* node, Result<> const& unzipResult) {
+    if (!unzipResult) {
+        this->addProblem({ LoadProblem::Type::Unknown, node, unzipResult.unwrapErr() });
+        log::error("Failed to unzip: {}", unzipResult.unwrapErr());
         m_refreshingModCount -= 1;
-    };
+        return;
+    }
 
-    if (early) {
-        auto res = unzipFunction();
+    if (node->shouldLoad()) {
+        log::debug("Loading binary");
+        auto res = node->m_impl->loadBinary();
         if (!res) {
-            this->addProblem({ LoadProblem::Type::Unknown, node, res.unwrapErr() });
-            log::error("Failed to unzip: {}", res.unwrapErr());
+            this->addProblem({
+                LoadProblem::Type::Unknown,
+                node,
+                res.unwrapErr()
+            });
+            log::error("Failed to load binary: {}", res.unwrapErr());
             m_refreshingModCount -= 1;
             return;
         }
-        loadFunction();
     }
-    else {
-        auto nest = log::saveNest();
-
-        async::runtime().spawnBlocking<void>([=, this]() {
-            log::loadNest(nest);
-            auto res = unzipFunction();
-            this->queueInMainThread([=, this, res = std::move(res)]() {
-                auto prevNest = log::saveNest();
-                log::loadNest(nest);
-                if (!res) {
-                    this->addProblem({ LoadProblem::Type::Unknown, node, res.unwrapErr() });
-                    log::error("Failed to unzip: {}", res.unwrapErr());
-                    m_refreshingModCount -= 1;
-                    log::loadNest(prevNest);
-                    return;
+
+    m_refreshingModCount -= 1;
+}
+
+void Loader::Impl::pollModExtractions() {
+    std::erase_if(m_pendingExtractions, [this](PendingExtraction const& pending) {
+        if (pending.result.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+            return false;
+        }
+        auto prevNest = log::saveNest();
+        log::loadNest(pending.nest);
+        this->finishLoadModGraph(pending.mod, pending.result.get());
+        log::loadNest(prevNest);
+        return true;
+    });
+}
+
+void Loader::Impl::extractModGraph() {
+    // Start unzipping every mod that is going to be loaded, in load order, so
+    // that by the time a mod's turn comes its files are most likely already
+    // there. Only a few extractions run at once so that the IO lane stays
+    // available for everything else that happens during startup.
+    // The binary is read ahead right after, so that loading it on the main
+    // thread mostly hits the page cache.
+    struct Job {
+        Mod* mod;
+        ModMetadata metadata;
+        bool prefetch;
+        std::promise<Result<>> promise;
+    };
+    auto jobs = std::make_shared<std::vector<Job>>();
+    for (auto mod : m_modsToLoad) {
+        if (!mod->getMetadata().checkGameVersion() || !mod->getMetadata().checkGeodeVersion()) {
+            continue;
+        }
+        if (mod->isLoaded() || m_modExtractions.contains(mod)) {
+            continue;
+        }
+        // a required dependency that isn't even installed is never going to resolve
+        if (std::ranges::any_of(mod->getMetadata().getDependencies(), [](auto const& dep) {
+            return dep.isRequired() && dep.getMod() == nullptr;
+        })) {
+            continue;
+        }
+        auto& job = jobs->emplace_back(Job {
+            mod, mod->getMetadata(), mod->shouldLoad() && !this->isSafeMode(), {}
+        });
+        m_modExtractions.emplace(mod, job.promise.get_future().share());
+    }
+    if (jobs->empty()) {
+        return;
+    }
+
+    constexpr size_t MAX_CONCURRENT_EXTRACTIONS = 4;
+    auto next = std::make_shared<std::atomic_size_t>(0);
+    auto workers = std::min(jobs->size(), MAX_CONCURRENT_EXTRACTIONS);
+    log::debug("Extracting {} mods", jobs->size());
+    for (size_t i = 0; i < workers; ++i) {
+        async::spawnBlocking(async::BlockingLane::IO, [this, jobs, next]() {
+            size_t index;
+            while ((index = next->fetch_add(1)) < jobs->size()) {
+                auto& job = (*jobs)[index];
+                auto res = [&] {
+                    trace::Span span("Unzipping", job.mod);
+                    return this->unzipGeodeFile(job.metadata);
+                }();
+                if (res && job.prefetch) {
+                    trace::Span span("Prefetching binary", job.mod);
+                    job.mod->m_impl->prefetchBinary();
                 }
-                loadFunction();
-                log::loadNest(prevNest);
-            });
+                job.promise.set_value(std::move(res));
+            }
         });
     }
 }
 
+std::shared_future<Result<>> Loader::Impl::takeModExtraction(Mod* node) {
+    if (auto it = m_modExtractions.find(node); it != m_modExtractions.end()) {
+        auto extraction = std::move(it->second);
+        m_modExtractions.erase(it);
+        return extraction;
+    }
+
+    // the mod was not part of the load order when extraction started, so unzip
+    // it now, still off the main thread
+    log::debug("Unzipping .geode file");
+    auto promise = std::make_shared<std::promise<Result<>>>();
+    auto extraction = promise->get_future().share();
+    async::spawnBlocking(async::BlockingLane::IO, [this, promise, metadata = node->getMetadata()]() {
+        promise->set_value(this->unzipGeodeFile(metadata));
+    });
+    return extraction;
+}
+
 void Loader::Impl::findProblems() {
     for (auto const& [id, mod] : m_mods) {
         // If this mod already has a problem, continue as usual
@@ -778,6 +998,7 @@ void Loader::Impl::refreshModGraph() {
     std::vector<ModMetadata> modQueue;
     {
         log::NestScope nest;
+        trace::Span span("Queueing mods");
         this->queueMods(modQueue);
     }
 
@@ -785,6 +1006,7 @@ void Loader::Impl::refreshModGraph() {
     log::info("Populating mod list");
     {
         log::NestScope nest;
+        trace::Span span("Populating mod list");
         this->populateModList(modQueue);
         modQueue.clear();
     }
@@ -793,19 +1015,28 @@ void Loader::Impl::refreshModGraph() {
     log::info("Building mod graph");
     {
         log::NestScope nest;
+        trace::Span span("Building mod graph");
         this->buildModGraph();
     }
 
     log::info("Ordering mod stack");
     {
         log::NestScope nest;
+        trace::Span span("Ordering mod stack");
         this->orderModStack();
     }
 
+    log::info("Extracting mods");
+    {
+        log::NestScope nest;
+        this->extractModGraph();
+    }
+
     m_loadingState = LoadingState::EarlyMods;
     log::info("Loading early mods");
     {
         log::NestScope nest;
+        trace::Span span("Loading early mods");
         while (!m_modsToLoad.empty() && m_modsToLoad.front()->needsEarlyLoad()) {
             auto mod = m_modsToLoad.front();
             m_modsToLoad.pop_front();
@@ -872,6 +1103,8 @@ void Loader::Impl::orderModStack() {
 }
 
 void Loader::Impl::continueRefreshModGraph() {
+    this->pollModExtractions();
+
     if (m_refreshingModCount != 0) {
         queueInMainThread([this]() {
             this->continueRefreshModGraph();
@@ -891,21 +1124,33 @@ void Loader::Impl::continueRefreshModGraph() {
     m_timerBegin = std::chrono::high_resolution_clock::now();
 
     switch (m_loadingState) {
-        case LoadingState::Mods:
-            if (!m_modsToLoad.empty()) {
+        case LoadingState::Mods: {
+            trace::Span span("Loading mods");
+            // keep loading mods this frame until the budget runs out, or until a mod
+            // has to wait for its extraction to finish
+            for (auto deadline = m_timerBegin + m_modLoadBudget; !m_modsToLoad.empty();) {
                 auto mod = m_modsToLoad.front();
                 m_modsToLoad.pop_front();
                 log::info("Loading mod {} {}", mod->getID(), mod->getVersion());
                 this->loadModGraph(mod, false);
+                if (m_refreshingModCount != 0 || std::chrono::high_resolution_clock::now() >= deadline) {
+                    break;
+                }
+            }
+            if (!m_modsToLoad.empty() || m_refreshingModCount != 0) {
                 break;
             }
+            // mods that had a problem never took their extraction
+            m_modExtractions.clear();
             m_loadingState = LoadingState::Problems;
+        }
             [[fallthrough]];
 
         case LoadingState::Problems:
             log::info("Finding problems");
             {
                 log::NestScope nest;
+                trace::Span span("Finding problems");
                 this->findProblems();
             }
             m_loadingState = LoadingState::Done;
@@ -967,11 +1212,64 @@ static bool isPlatformBinary(std::string_view modID, std::string_view filename)
         || filename.ends_with(".ios.dylib");
 }
 
+namespace {
+    // CRC32 and size of every file that was extracted from a .geode, so that
+    // the next extraction only has to rewrite the files that actually changed
+    struct ExtractedEntry {
+        uint32_t crc32;
+        uint64_t size;
+    };
+    using ExtractedManifest = std::unordered_map<std::string, ExtractedEntry>;
+
+    std::optional<ExtractedManifest> readExtractedManifest(std::filesystem::path const& path) {
+        auto res = file::readJson(path);
+        if (!res) {
+            return std::nullopt;
+        }
+        auto json = std::move(res).unwrap();
+
+        ExtractedManifest manifest;
+        for (auto const& item : json) {
+            auto entry = item["path"].asString();
+            auto crc32 = item["crc32"].asUInt();
+            auto size = item["size"].asUInt();
+            if (!entry || !crc32 || !size) {
+                return std::nullopt;
+            }
+            manifest.insert({ std::move(entry).unwrap(), ExtractedEntry {
+                .crc32 = static_cast<uint32_t>(crc32.unwrap()),
+                .size = static_cast<uint64_t>(size.unwrap()),
+            } });
+        }
+        return manifest;
+    }
+
+    Result<> writeExtractedManifest(std::filesystem::path const& path, ExtractedManifest const& manifest) {
+        auto json = matjson::Value::array();
+        for (auto const& [entry, info] : manifest) {
+            json.push(matjson::makeObject({
+                { "path", entry },
+                { "crc32", info.crc32 },
+                { "size", info.size },
+            }));
+        }
+        return file::writeStringSafe(path, json.dump(matjson::NO_INDENTATION));
+    }
+
+    // the manifest is only ever written by us, but it's still a file on disk
+    bool isContainedEntry(std::filesystem::path const& entry) {
+        return entry.is_relative() && std::ranges::none_of(entry, [](auto const& part) {
+            return part == "..";
+        });
+    }
+}
+
 Result<> Loader::Impl::unzipGeodeFile(ModMetadata metadata) {
     // Unzip .geode file into temp dir
     auto tempDir = dirs::getModRuntimeDir() / metadata.getID();
 
     auto datePath = tempDir / "modified-at";
+    auto manifestPath = tempDir / "extracted-entries.json";
     std::string currentHash = file::readString(datePath).unwrapOr("");
 
     std::error_code ec;
@@ -988,39 +1286,77 @@ Result<> Loader::Impl::unzipGeodeFile(ModMetadata metadata) {
     }
     log::debug("Hash mismatch detected, unzipping");
 
-    std::filesystem::remove_all(tempDir, ec);
-    if (ec) {
-        auto message = formatSystemError(ec.value());
-        return Err("Unable to delete temp dir: " + message GEODE_WINDOWS( + " Try <cg>restarting your PC</c> to fix the issue."));
-    }
-
-    (void)utils::file::createDirectoryAll(tempDir);
-
     GEODE_UNWRAP_INTO(auto unzip, file::Unzip::create(metadata.getPath()));
     if (!unzip.hasEntry(metadata.getBinaryName())) {
         return Err(
             fmt::format("Unable to find platform binary under the name \"{}\"", metadata.getBinaryName())
         );
     }
-    GEODE_UNWRAP(unzip.extractAllTo(tempDir));
 
-    // Delete binaries for other platforms since they're pointless
-    // The if should never fail, but you never know
-    for (auto& entry : std::filesystem::directory_iterator(tempDir)) {
-        if (entry.is_directory()) {
-            continue;
+    // Without a manifest there's no telling what is in the dir, so start over
+    auto previous = readExtractedManifest(manifestPath);
+    if (!previous) {
+        std::filesystem::remove_all(tempDir, ec);
+        if (ec) {
+            auto message = formatSystemError(ec.value());
+            return Err("Unable to delete temp dir: " + message GEODE_WINDOWS( + " Try <cg>restarting your PC</c> to fix the issue."));
         }
+        previous.emplace();
+    }
+    else {
+        // If extraction fails halfway through, the dir no longer matches the
+        // manifest, so the next attempt has to start over
+        std::filesystem::remove(manifestPath, ec);
+        std::filesystem::remove(datePath, ec);
+    }
 
-        const std::string filename = utils::string::pathToString(entry.path().filename());
-        if (metadata.getBinaryName() == filename || !isPlatformBinary(metadata.getID(), filename)) {
-            continue;
+    (void)utils::file::createDirectoryAll(tempDir);
+
+    ExtractedManifest current;
+    size_t rewritten = 0;
+    GEODE_UNWRAP(unzip.extractAllTo(tempDir, [&](std::filesystem::path const& entry) {
+        auto info = unzip.getEntryInfo(entry);
+        if (!info || info->isDirectory) {
+            return true;
+        }
+
+        // Binaries for other platforms are pointless
+        auto filename = utils::string::pathToString(entry.filename());
+        if (!entry.has_parent_path() && metadata.getBinaryName() != filename && isPlatformBinary(metadata.getID(), filename)) {
+            return false;
+        }
+
+        auto key = utils::string::pathToString(entry);
+        current.insert({ key, ExtractedEntry { .crc32 = info->crc32, .size = info->size } });
+
+        auto old = previous->find(key);
+        if (
+            old != previous->end() &&
+            old->second.crc32 == info->crc32 &&
+            old->second.size == info->size &&
+            std::filesystem::exists(tempDir / entry)
+        ) {
+            return false;
         }
+        rewritten += 1;
+        return true;
+    }));
 
-        // The binary is not for our platform, delete!
+    // Delete whatever the previous version had that this one doesn't
+    size_t removed = 0;
+    for (auto const& [key, _] : *previous) {
+        if (current.contains(key)) {
+            continue;
+        }
+        std::filesystem::path entry(key);
+        if (!isContainedEntry(entry)) {
+            continue;
+        }
         // We don't really care if the deletion succeeds though.
         std::error_code ec;
-        std::filesystem::remove(entry.path(), ec);
+        removed += std::filesystem::remove(tempDir / entry, ec) ? 1 : 0;
     }
+    log::debug("Rewrote {} of {} files, removed {}", rewritten, current.size(), removed);
 
     // Check if there is a binary that we need to move over from the unzipped binaries dir
     if (this->isPatchless()) {
@@ -1037,9 +1373,16 @@ Result<> Loader::Impl::unzipGeodeFile(ModMetadata metadata) {
                     src, dst, message
                 ));
             }
+            // The binary on disk no longer matches the one in the zip
+            current.erase(utils::string::pathToString(metadata.getBinaryName()));
         }
     }
 
+    if (auto res = writeExtractedManifest(manifestPath, current); !res) {
+        log::warn("Failed to write extracted entries of geode zip, will fully unzip next launch: {}", res.unwrapErr());
+        return Ok();
+    }
+
     auto res = file::writeString(datePath, modifiedHash);
     if (!res) {
         log::warn("Failed to write modified date of geode zip, will try to unzip next launch: {}", res.unwrapErr());
@@ -1069,13 +1412,23 @@ Result<> Loader::Impl::extractBinary(ModMetadata metadata) {
 }
 
 bool Loader::Impl::loadHooks() {
+    trace::Span span("Loading hooks");
     m_readyToHook = true;
     bool hadErrors = false;
+    HookBatch batch;
     for (auto const& [hook, mod] : m_uninitializedHooks) {
-        auto res = hook->enable();
-        if (!res) {
-            log::logImpl(Severity::Error, mod, "{}", res.unwrapErr());
-            hadErrors = true;
+        batch.enable(hook);
+    }
+    if (!batch.commit()) {
+        // the batch was reverted, enable them one by one so that every failure
+        // is reported to the mod it belongs to
+        for (auto const& [hook, mod] : m_uninitializedHooks) {
+            if (hook->isEnabled()) continue;
+            auto res = hook->enable();
+            if (!res) {
+                log::logImpl(Severity::Error, mod, "{}", res.unwrapErr());
+                hadErrors = true;
+            }
         }
     }
     m_uninitializedHooks.clear();
@@ -1083,32 +1436,36 @@ bool Loader::Impl::loadHooks() {
 }
 
 void Loader::Impl::queueInMainThread(ScheduledFunction&& func) {
-    std::lock_guard<std::mutex> lock(m_mainThreadMutex);
-    m_mainThreadQueue.push_back(std::move(func));
+    this->queueInMainThread(std::move(func), MainThreadPriority::UI);
 }
 
-void Loader::Impl::executeMainThreadQueue() {
-    m_mainThreadMutex.lock();
+void Loader::Impl::queueInMainThread(ScheduledFunction&& func, MainThreadPriority priority) {
+    m_mainThreadLanes[std::min(static_cast<size_t>(priority), m_mainThreadLanes.size() - 1)].push(std::move(func));
+}
+
+void Loader::Impl::setMainThreadBudget(std::chrono::microseconds budget) {
+    m_mainThreadBudget = std::max(budget, std::chrono::microseconds(0));
+}
 
-    // to prevent allocating an extra vector every frame we have a separate temp queue,
-    // where we first move all functions before executing them.
-    // this means there are no allocations in the common case, and we maintain deadlock safety
-    // since we do not call any functions while holding the mutex
+std::chrono::microseconds Loader::Impl::getMainThreadBudget() const {
+    return m_mainThreadBudget;
+}
 
-    auto& queue = m_mainThreadQueue;
-    auto& execQueue = m_mainThreadQueueExec;
-    execQueue.reserve(queue.size());
-    std::move(queue.begin(), queue.end(), std::back_inserter(execQueue));
-    queue.clear();
+MainThreadLaneMetrics Loader::Impl::getMainThreadLaneMetrics(MainThreadPriority priority) const {
+    return m_mainThreadLanes[std::min(static_cast<size_t>(priority), m_mainThreadLanes.size() - 1)].getMetrics();
+}
 
-    m_mainThreadMutex.unlock();
+void Loader::Impl::executeMainThreadQueue() {
+    [[maybe_unused]] static bool s_markedMainThread = (comm::markMainEventThread(), true);
+    auto deadline = std::chrono::steady_clock::now() + m_mainThreadBudget.load();
 
-    // call all functions
-    for (auto& func : execQueue) {
-        func();
-    }
+    m_mainThreadLanes[static_cast<size_t>(MainThreadPriority::InputCritical)].drain();
+    // the other lanes always get to run at least one function, so they can not be starved
+    m_mainThreadLanes[static_cast<size_t>(MainThreadPriority::UI)].drain(deadline, 1);
+    m_mainThreadLanes[static_cast<size_t>(MainThreadPriority::Background)].drain(deadline, 1);
 
-    execQueue.clear();
+    // events posted to the main thread's event center
+    comm::EventCenterThreadLocal::get()->processPosted();
 }
 
 void Loader::Impl::provideNextMod(Mod* mod) {
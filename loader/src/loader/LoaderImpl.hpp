@@ -10,8 +10,16 @@
 #include <Geode/utils/ranges.hpp>
 #include <Geode/utils/function.hpp>
 #include <Geode/utils/StringMap.hpp>
+#include "MainThreadQueue.hpp"
 #include "ModImpl.hpp"
+#include "SpritesheetCache.hpp"
 #include <crashlog.hpp>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <future>
+#include <memory>
 #include <mutex>
 #include <optional>
 #include <thread>
@@ -35,14 +43,21 @@ namespace geode {
         std::vector<LoadProblem> m_problems;
         StringMap<Mod*> m_mods;
         std::deque<Mod*> m_modsToLoad;
+        // .geode files are extracted ahead of time as soon as the load order is known
+        std::unordered_map<Mod*, std::shared_future<Result<>>> m_modExtractions;
+        struct PendingExtraction {
+            Mod* mod;
+            std::shared_future<Result<>> result;
+            std::shared_ptr<log::Nest> nest;
+        };
+        std::vector<PendingExtraction> m_pendingExtractions;
         std::vector<std::filesystem::path> m_texturePaths;
         bool m_isSetup = false;
 
         LoadingState m_loadingState = LoadingState::None;
 
-        std::vector<geode::Function<void(void)>> m_mainThreadQueue;
-        std::vector<geode::Function<void(void)>> m_mainThreadQueueExec; // see comments in loaderimpl.cpp for the purpose
-        mutable std::mutex m_mainThreadMutex;
+        std::array<MainThreadQueue, 3> m_mainThreadLanes;
+        std::atomic<std::chrono::microseconds> m_mainThreadBudget{std::chrono::milliseconds(8)};
         std::vector<std::pair<Hook*, Mod*>> m_uninitializedHooks;
         bool m_readyToHook = false;
 
@@ -61,6 +76,8 @@ namespace geode {
         utils::StringMap<std::string> m_launchArgs;
 
         std::chrono::time_point<std::chrono::high_resolution_clock> m_timerBegin;
+        // how long continueRefreshModGraph may spend loading mods in a single frame
+        std::chrono::milliseconds m_modLoadBudget{8};
 
         std::string getGameVersion();
         bool isForwardCompatMode();
@@ -88,6 +105,29 @@ namespace geode {
         void removeDirectories();
 
         void updateModResources(Mod* mod);
+
+        // A mod spritesheet whose png is decoded and plist read on the CPU lane,
+        // uploading it and registering its frames happens on the main thread afterwards
+        struct PendingSpritesheet {
+            Mod* mod;
+            std::string png;
+            std::string plist;
+            cocos2d::CCImage* image = nullptr;
+            std::optional<std::vector<CachedSpriteFrame>> frames;
+            std::atomic_bool decoded = false;
+        };
+        // in the order the sheets were requested in, so that frames with the
+        // same name override each other the same way they always have
+        // shared with the decoding job, which still touches it after marking it decoded
+        std::deque<std::shared_ptr<PendingSpritesheet>> m_pendingSpritesheets;
+
+        void loadSpritesheet(Mod* mod, std::string png, std::string plist);
+        void uploadSpritesheet(PendingSpritesheet& sheet);
+        // Uploads decoded sheets in order until the deadline passes, returns
+        // whether every sheet has been uploaded
+        bool uploadSpritesheets(std::chrono::steady_clock::time_point deadline);
+        // Blocks until every sheet has been decoded and uploads all of them
+        void finishSpritesheets();
         void addSearchPaths();
         void addNativeBinariesPath(std::filesystem::path const& path);
 
@@ -106,7 +146,11 @@ namespace geode {
         void populateModList(std::vector<ModMetadata>& modQueue);
         void buildModGraph();
         void orderModStack();
+        void extractModGraph();
+        std::shared_future<Result<>> takeModExtraction(Mod* node);
         void loadModGraph(Mod* node, bool early);
+        void finishLoadModGraph(Mod* node, Result<> const& unzipResult);
+        void pollModExtractions();
         void findProblems();
         void refreshModGraph();
         void continueRefreshModGraph();
@@ -126,9 +170,15 @@ namespace geode {
         std::optional<std::string> getLaunchArgument(std::string_view name) const;
         bool getLaunchFlag(std::string_view name) const;
 
-        void updateResources(bool forceReload);
+        // With deferUploads, spritesheets are left for uploadSpritesheets to
+        // finish over the next frames instead of being waited for
+        void updateResources(bool forceReload, bool deferUploads = false);
 
         void queueInMainThread(ScheduledFunction&& func);
+        void queueInMainThread(ScheduledFunction&& func, MainThreadPriority priority);
+        void setMainThreadBudget(std::chrono::microseconds budget);
+        std::chrono::microseconds getMainThreadBudget() const;
+        MainThreadLaneMetrics getMainThreadLaneMetrics(MainThreadPriority priority) const;
         void executeMainThreadQueue();
 
         bool isReadyToHook() const;
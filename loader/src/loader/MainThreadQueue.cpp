@@ -0,0 +1,130 @@
+#include "MainThreadQueue.hpp"
+
+#include <algorithm>
+#include <array>
+#include <utility>
+
+using namespace geode::prelude;
+
+// Nodes a producer thread took from the free list of one queue, so that it only
+// has to touch the shared free list once per batch instead of once per push
+struct MainThreadQueue::NodeCache {
+    MainThreadQueue* owner = nullptr;
+    Node* first = nullptr;
+
+    ~NodeCache() {
+        if (!owner || !first) return;
+        auto last = first;
+        while (auto next = last->next.load(std::memory_order_relaxed)) {
+            last = next;
+        }
+        owner->recycleList(first, last);
+    }
+};
+
+// One cache per queue a thread pushes to, enough for every main thread lane
+static constexpr size_t NODE_CACHES_PER_THREAD = 4;
+
+MainThreadQueue::MainThreadQueue() : m_head(new Node()), m_tail(m_head) {}
+
+MainThreadQueue::~MainThreadQueue() {
+    auto deleteList = [](Node* node) {
+        while (node) {
+            auto next = node->next.load(std::memory_order_relaxed);
+            delete node;
+            node = next;
+        }
+    };
+    deleteList(m_head);
+    deleteList(m_free.exchange(nullptr));
+}
+
+MainThreadQueue::Node* MainThreadQueue::allocate() {
+    static thread_local std::array<NodeCache, NODE_CACHES_PER_THREAD> caches;
+
+    auto it = std::find_if(caches.begin(), caches.end(), [this](NodeCache const& cache) {
+        return cache.owner == this || !cache.owner;
+    });
+    if (it == caches.end()) {
+        // this thread pushes to more queues than it has caches for
+        m_allocated.fetch_add(1, std::memory_order_relaxed);
+        return new Node();
+    }
+    auto& cache = *it;
+    cache.owner = this;
+    if (!cache.first) {
+        cache.first = m_free.exchange(nullptr, std::memory_order_acquire);
+    }
+    if (auto node = cache.first) {
+        cache.first = node->next.load(std::memory_order_relaxed);
+        node->next.store(nullptr, std::memory_order_relaxed);
+        return node;
+    }
+    m_allocated.fetch_add(1, std::memory_order_relaxed);
+    return new Node();
+}
+
+void MainThreadQueue::recycle(Node* node) {
+    node->func = nullptr;
+    this->recycleList(node, node);
+}
+
+void MainThreadQueue::recycleList(Node* first, Node* last) {
+    auto head = m_free.load(std::memory_order_relaxed);
+    do {
+        last->next.store(head, std::memory_order_relaxed);
+    } while (!m_free.compare_exchange_weak(head, first, std::memory_order_release, std::memory_order_relaxed));
+}
+
+void MainThreadQueue::push(ScheduledFunction&& func) {
+    auto node = this->allocate();
+    node->func = std::move(func);
+    node->queuedAt = std::chrono::steady_clock::now();
+    m_depth.fetch_add(1, std::memory_order_relaxed);
+    auto prev = m_tail.exchange(node, std::memory_order_acq_rel);
+    // between the exchange and this store the node is not reachable yet,
+    // drain treats that the same as an empty queue
+    prev->next.store(node, std::memory_order_release);
+}
+
+size_t MainThreadQueue::drain(std::chrono::steady_clock::time_point deadline, size_t minimum) {
+    // anything pushed after this point is left for the next drain
+    auto last = m_tail.load(std::memory_order_acquire);
+    size_t count = 0;
+    std::chrono::steady_clock::duration totalLatency{}, maxLatency{};
+    while (m_head != last) {
+        auto now = std::chrono::steady_clock::now();
+        if (count >= minimum && now >= deadline) break;
+
+        auto next = m_head->next.load(std::memory_order_acquire);
+        if (!next) break;
+
+        auto func = std::move(next->func);
+        auto latency = now - next->queuedAt;
+        this->recycle(std::exchange(m_head, next));
+        m_depth.fetch_sub(1, std::memory_order_relaxed);
+
+        totalLatency += latency;
+        maxLatency = std::max(maxLatency, latency);
+        func();
+        count += 1;
+    }
+
+    m_executed.store(count, std::memory_order_relaxed);
+    m_averageLatency.store(
+        std::chrono::duration_cast<std::chrono::microseconds>(count ? totalLatency / static_cast<std::chrono::steady_clock::rep>(count) : totalLatency),
+        std::memory_order_relaxed
+    );
+    m_maxLatency.store(std::chrono::duration_cast<std::chrono::microseconds>(maxLatency), std::memory_order_relaxed);
+    return count;
+}
+
+MainThreadLaneMetrics MainThreadQueue::getMetrics() const {
+    return MainThreadLaneMetrics {
+        .queueDepth = m_depth.load(std::memory_order_relaxed),
+        .executedLastFrame = m_executed.load(std::memory_order_relaxed),
+        .averageLatency = m_averageLatency.load(std::memory_order_relaxed),
+        .maxLatency = m_maxLatency.load(std::memory_order_relaxed),
+        .allocatedNodes = m_allocated.load(std::memory_order_relaxed),
+    };
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <Geode/loader/Loader.hpp>
+#include <atomic>
+#include <chrono>
+
+namespace geode {
+    // Multi-producer, single-consumer queue of functions for the main thread.
+    // Pushing is a single atomic exchange and draining takes no locks at all.
+    // Nodes are recycled through a free list and a per-thread cache for each queue,
+    // so in the steady state pushing does not allocate anything besides the function itself.
+    class MainThreadQueue final {
+    public:
+        MainThreadQueue();
+        ~MainThreadQueue();
+
+        MainThreadQueue(MainThreadQueue const&) = delete;
+        MainThreadQueue& operator=(MainThreadQueue const&) = delete;
+
+        // Can be called from any thread
+        void push(ScheduledFunction&& func);
+
+        // Runs every function that was pushed before this call, returns how many ran.
+        // Functions pushed while draining run on the next drain. Stops early once the
+        // deadline has passed and at least `minimum` functions ran. Only call this
+        // from a single thread at a time.
+        size_t drain(
+            std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::time_point::max(),
+            size_t minimum = 0
+        );
+
+        // Depth and allocations are live, everything else is about the last drain
+        MainThreadLaneMetrics getMetrics() const;
+
+    private:
+        struct Node {
+            std::atomic<Node*> next = nullptr;
+            ScheduledFunction func;
+            std::chrono::steady_clock::time_point queuedAt;
+        };
+        struct NodeCache;
+
+        Node* allocate();
+        void recycle(Node* node);
+        void recycleList(Node* first, Node* last);
+
+        // the consumer owns m_head, which is always an already consumed stub node
+        alignas(64) Node* m_head;
+        alignas(64) std::atomic<Node*> m_tail;
+        // only ever taken from as a whole, so there is no ABA problem
+        alignas(64) std::atomic<Node*> m_free = nullptr;
+
+        std::atomic_size_t m_depth = 0;
+        std::atomic_size_t m_allocated = 0;
+        std::atomic_size_t m_executed = 0;
+        std::atomic<std::chrono::microseconds> m_averageLatency{};
+        std::atomic<std::chrono::microseconds> m_maxLatency{};
+    };
+}
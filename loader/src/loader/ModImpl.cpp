@@ -17,14 +17,22 @@
 #include <Geode/utils/file.hpp>
 #include <Geode/utils/JsonValidation.hpp>
 #include <Geode/utils/string.hpp>
+#include <Geode/utils/trace.hpp>
 #include <algorithm>
+#include <chrono>
 #include <filesystem>
+#include <fstream>
 #include <optional>
 #include <string>
 #include <system_error>
 #include <vector>
 #include <string_view>
 
+#ifdef GEODE_IS_ANDROID
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
 using namespace geode::prelude;
 
 static constexpr const char* humanReadableDescForAction(ModRequestedAction action) {
@@ -342,12 +350,26 @@ Result<> Mod::Impl::loadBinary() {
 
     m_loaded = true;
     m_isCurrentlyLoading = true;
+    auto loadBegin = trace::Clock::now();
     auto res = this->loadPlatformBinary();
+    auto loadEnd = trace::Clock::now();
+    trace::addSpan("Loading binary", m_self, loadBegin, loadEnd);
+    m_binaryLoadTime = std::chrono::duration_cast<std::chrono::microseconds>(loadEnd - loadBegin);
+    log::debug(
+        "Binary took {}ms to load, {}ms were spent prefetching it beforehand",
+        m_binaryLoadTime.count() / 1000.f, m_binaryPrefetchTime.count() / 1000.f
+    );
     if (!res) {
         // disable hooks/patches the mod managed to register before failure
         // note that this will not save from any other side effects (i.e. registering an event listener)
-        for (auto patch : m_patches) { (void) patch->disable(); }
-        for (auto hook : m_hooks) { (void) hook->disable(); }
+        HookBatch batch;
+        for (auto& patch : m_patches) { batch.disable(patch.get()); }
+        for (auto& hook : m_hooks) { batch.disable(hook.get()); }
+        if (!batch.commit()) {
+            // something refused to be disabled, at least get everything else
+            for (auto& patch : m_patches) { (void) patch->disable(); }
+            for (auto& hook : m_hooks) { (void) hook->disable(); }
+        }
         m_patches.clear();
         m_hooks.clear();
 
@@ -378,6 +400,29 @@ Result<> Mod::Impl::loadBinary() {
     return Ok();
 }
 
+void Mod::Impl::prefetchBinary() {
+    auto begin = std::chrono::steady_clock::now();
+    auto path = this->getBinaryPath();
+
+#ifdef GEODE_IS_ANDROID
+    // the kernel can read the whole thing ahead in one go
+    auto fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return;
+    posix_fadvise(fd, 0, 0, POSIX_FADV_WILLNEED);
+    close(fd);
+#else
+    // elsewhere just read the file once, sequentially, and throw the data away
+    std::ifstream file(path, std::ios::binary);
+    if (!file) return;
+    std::vector<char> buffer(1024 * 1024);
+    while (file.read(buffer.data(), buffer.size()) || file.gcount() > 0) {}
+#endif
+
+    m_binaryPrefetchTime = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - begin
+    );
+}
+
 Result<> Mod::Impl::enable() {
     switch (m_requestedAction) {
         // Allow reverting disabling
@@ -674,6 +719,8 @@ ModJson Mod::Impl::getRuntimeInfo() const {
         obj["patches"].push(ModJson(patch->getRuntimeInfo()));
     }
     obj["loaded"] = m_loaded;
+    obj["binary-prefetch-us"] = m_binaryPrefetchTime.count();
+    obj["binary-load-us"] = m_binaryLoadTime.count();
     obj["temp-dir"] = this->getTempDir();
     obj["save-dir"] = this->getSaveDir();
     obj["config-dir"] = this->getConfigDir(false);
@@ -31,6 +31,12 @@ namespace geode {
          * Whether the mod is loaded or not
          */
         bool m_loaded = false;
+        /**
+         * How long reading the binary ahead of time took on the IO lane, and how
+         * long loading it took on the main thread afterwards
+         */
+        std::chrono::microseconds m_binaryPrefetchTime{};
+        std::chrono::microseconds m_binaryLoadTime{};
         /**
          * Mod temp directory name
          */
@@ -82,6 +88,9 @@ namespace geode {
         Result<> setup();
 
         Result<> loadPlatformBinary();
+        // Pulls the binary into the page cache so that loading it doesn't stall on disk reads.
+        // Safe to call from any thread
+        void prefetchBinary();
         Result<> createTempDir();
 
         ZStringView getID() const;
@@ -808,18 +808,23 @@ ModMetadata ModMetadata::Impl::createInvalidMetadata(
     return v;
 }
 ModMetadata ModMetadata::createFromGeodeFile(std::filesystem::path const& path) {
-    // result code looks weird when you don't want to return a result
-
-    // Try guess ID from filename (since usually Geode mods are named `mod.id.geode`)
-    std::optional<std::string> guessedID = utils::string::pathToString(path.stem());
-    if (!ModMetadata::validateID(*guessedID)) {
-        guessedID = std::nullopt;
+    return Impl::createFromGeodeFile(path, nullptr);
+}
+ModMetadata ModMetadata::Impl::createFromGeodeFile(std::filesystem::path const& path, ModMetadataIndex* index) {
+    return Impl::createFromGeodeFile(path, Impl::readGeodeFile(path, index), index);
+}
+ModMetadata::Impl::GeodeFileContents ModMetadata::Impl::readGeodeFile(std::filesystem::path const& path, ModMetadataIndex* index) {
+    // Unchanged packages do not need to be opened again
+    if (index) {
+        if (auto entry = index->find(path)) {
+            return GeodeFileContents { .entry = std::move(entry), .fromIndex = true };
+        }
     }
 
     // Attempt to unzip, otherwise return invalid mod with unzip error
     auto r = file::Unzip::create(path);
     if (!r) {
-        return Impl::createInvalidMetadata(path, r.unwrapErr(), guessedID);
+        return GeodeFileContents { .error = std::move(r.unwrapErr()) };
     }
 
     auto&& unzip = std::move(r.unwrap());
@@ -828,7 +833,7 @@ ModMetadata ModMetadata::createFromGeodeFile(std::filesystem::path const& path)
 
     // First check if mod.json exists for a nicer error
     if (!unzip.hasEntry("mod.json")) {
-        return Impl::createInvalidMetadata(path, "Geode package is missing \"mod.json\"", guessedID);
+        return GeodeFileContents { .error = "Geode package is missing \"mod.json\"" };
     }
 
     // Extract file
@@ -836,7 +841,7 @@ ModMetadata ModMetadata::createFromGeodeFile(std::filesystem::path const& path)
         return fmt::format("Unable to extract mod.json: {}", err);
     });
     if (!modJsonDataRes) {
-        return Impl::createInvalidMetadata(path, modJsonDataRes.unwrapErr(), guessedID);
+        return GeodeFileContents { .error = std::move(modJsonDataRes.unwrapErr()) };
     }
     auto&& modJsonData = std::move(modJsonDataRes.unwrap());
 
@@ -846,16 +851,49 @@ ModMetadata ModMetadata::createFromGeodeFile(std::filesystem::path const& path)
             return fmt::format("Unable to parse mod.json: {}", err);
         });
     if (!modJsonRes) {
-        return Impl::createInvalidMetadata(path, modJsonRes.unwrapErr(), guessedID);
+        return GeodeFileContents { .error = std::move(modJsonRes.unwrapErr()) };
+    }
+
+    GeodeFileContents contents;
+    ModMetadata::Impl files;
+    if (auto res = files.addSpecialFiles(unzip); !res) {
+        contents.specialFilesError = std::move(res.unwrapErr());
+    }
+    contents.entry = ModMetadataIndex::Entry {
+        .modJson = std::move(modJsonRes.unwrap()),
+        .details = std::move(files.m_details),
+        .changelog = std::move(files.m_changelog),
+        .supportInfo = std::move(files.m_supportInfo),
+    };
+    return contents;
+}
+ModMetadata ModMetadata::Impl::createFromGeodeFile(
+    std::filesystem::path const& path,
+    GeodeFileContents contents,
+    ModMetadataIndex* index
+) {
+    // Try guess ID from filename (since usually Geode mods are named `mod.id.geode`)
+    std::optional<std::string> guessedID = utils::string::pathToString(path.stem());
+    if (!ModMetadata::validateID(*guessedID)) {
+        guessedID = std::nullopt;
     }
-    auto&& modJson = std::move(modJsonRes.unwrap());
 
-    auto info = Impl::parse(modJson, guessedID);
+    if (!contents.entry) {
+        return Impl::createInvalidMetadata(path, contents.error, guessedID);
+    }
+    auto& entry = *contents.entry;
+
+    auto info = Impl::parse(entry.modJson, guessedID);
     info.m_impl->m_path = path;
+    info.m_impl->m_details = entry.details;
+    info.m_impl->m_changelog = entry.changelog;
+    info.m_impl->m_supportInfo = entry.supportInfo;
 
-    auto specialFilesRes = info.m_impl->addSpecialFiles(unzip);
-    if (!specialFilesRes) {
-        info.m_impl->m_errors.emplace_back(fmt::format("Unable to add extra files: {}", specialFilesRes.unwrapErr()));
+    if (contents.specialFilesError) {
+        info.m_impl->m_errors.emplace_back(fmt::format("Unable to add extra files: {}", *contents.specialFilesError));
+    }
+    else if (index && !contents.fromIndex) {
+        index->insert(path, std::move(entry));
     }
 
     return info;
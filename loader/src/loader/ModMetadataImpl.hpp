@@ -6,6 +6,7 @@
 #include <Geode/utils/VersionInfo.hpp>
 #include <Geode/utils/StringMap.hpp>
 #include <Geode/loader/Setting.hpp>
+#include "ModMetadataIndex.hpp"
 #include <compare>
 
 using namespace geode::prelude;
@@ -115,6 +116,25 @@ namespace geode {
         static bool validateID(std::string_view id);
 
         static ModMetadata parse(ModJson const& rawJson, std::optional<std::string_view> guessedID);
+        // What a .geode file contributes to its metadata. Reading it logs nothing,
+        // so it can happen on any thread while parsing stays in a set order
+        struct GeodeFileContents {
+            // mod.json and the special files, if the package could be read
+            std::optional<ModMetadataIndex::Entry> entry;
+            std::string error;
+            // reading about.md and the like failed, which keeps it out of the index
+            std::optional<std::string> specialFilesError;
+            bool fromIndex = false;
+        };
+        // Goes through the index first if one is given
+        static GeodeFileContents readGeodeFile(std::filesystem::path const& path, ModMetadataIndex* index);
+        // Parses what readGeodeFile read, and adds it to the index on a miss
+        static ModMetadata createFromGeodeFile(
+            std::filesystem::path const& path,
+            GeodeFileContents contents,
+            ModMetadataIndex* index
+        );
+        static ModMetadata createFromGeodeFile(std::filesystem::path const& path, ModMetadataIndex* index);
         static ModMetadata createInvalidMetadata(
             std::filesystem::path const& path,
             std::string_view error,
@@ -0,0 +1,133 @@
+#include "ModMetadataIndex.hpp"
+
+#include <Geode/loader/Log.hpp>
+#include <Geode/utils/file.hpp>
+#include <Geode/utils/string.hpp>
+
+using namespace geode::prelude;
+
+// bump this whenever the format of the entries changes
+static constexpr int INDEX_FORMAT = 1;
+
+namespace {
+    struct FileStamp {
+        uint64_t size = 0;
+        int64_t modifiedAt = 0;
+    };
+
+    std::optional<FileStamp> stampOf(std::filesystem::path const& path) {
+        std::error_code ec;
+        auto size = std::filesystem::file_size(path, ec);
+        if (ec) return std::nullopt;
+        auto time = std::filesystem::last_write_time(path, ec);
+        if (ec) return std::nullopt;
+        return FileStamp {
+            .size = static_cast<uint64_t>(size),
+            .modifiedAt = static_cast<int64_t>(time.time_since_epoch().count()),
+        };
+    }
+
+    std::optional<std::string> optionalString(matjson::Value const& value) {
+        if (!value.isString()) return std::nullopt;
+        return value.asString().ok();
+    }
+
+    matjson::Value optionalValue(std::optional<std::string> const& value) {
+        return value ? matjson::Value(*value) : matjson::Value(nullptr);
+    }
+}
+
+ModMetadataIndex::ModMetadataIndex(std::filesystem::path path) : m_path(std::move(path)) {
+    if (!std::filesystem::exists(m_path)) return;
+
+    auto res = file::readJson(m_path);
+    if (!res) {
+        log::warn("Unable to read mod index, ignoring it: {}", res.unwrapErr());
+        return;
+    }
+    auto json = std::move(res).unwrap();
+
+    // the loader version is part of the key since parsing may change between versions
+    if (json["format"].asInt().unwrapOr(0) != INDEX_FORMAT ||
+        json["loader"].asString().unwrapOr("") != Loader::get()->getVersion().toVString()
+    ) {
+        return;
+    }
+
+    for (auto const& item : json["entries"]) {
+        auto path = item["path"].asString();
+        auto size = item["size"].asUInt();
+        auto modifiedAt = item["modified-at"].asInt();
+        if (!path || !size || !modifiedAt || !item["mod.json"].isObject()) continue;
+
+        m_entries.insert_or_assign(std::move(path).unwrap(), Stored {
+            .size = static_cast<uint64_t>(size.unwrap()),
+            .modifiedAt = static_cast<int64_t>(modifiedAt.unwrap()),
+            .entry = Entry {
+                .modJson = item["mod.json"],
+                .details = optionalString(item["about.md"]),
+                .changelog = optionalString(item["changelog.md"]),
+                .supportInfo = optionalString(item["support.md"]),
+            },
+        });
+    }
+}
+
+std::optional<ModMetadataIndex::Entry> ModMetadataIndex::find(std::filesystem::path const& geodeFile) {
+    auto stamp = stampOf(geodeFile);
+    if (!stamp) return std::nullopt;
+
+    std::lock_guard lock(m_mutex);
+    auto it = m_entries.find(utils::string::pathToString(geodeFile));
+    if (it == m_entries.end()) return std::nullopt;
+    if (it->second.size != stamp->size || it->second.modifiedAt != stamp->modifiedAt) return std::nullopt;
+
+    it->second.used = true;
+    return it->second.entry;
+}
+
+void ModMetadataIndex::insert(std::filesystem::path const& geodeFile, Entry entry) {
+    auto stamp = stampOf(geodeFile);
+    if (!stamp) return;
+
+    std::lock_guard lock(m_mutex);
+    m_entries.insert_or_assign(utils::string::pathToString(geodeFile), Stored {
+        .size = stamp->size,
+        .modifiedAt = stamp->modifiedAt,
+        .entry = std::move(entry),
+        .used = true,
+    });
+    m_dirty = true;
+}
+
+Result<> ModMetadataIndex::save() {
+    std::lock_guard lock(m_mutex);
+
+    // forget mods that were removed
+    auto removed = std::erase_if(m_entries, [](auto const& pair) {
+        return !pair.second.used;
+    });
+    if (!m_dirty && removed == 0) return Ok();
+
+    auto entries = matjson::Value::array();
+    for (auto const& [path, stored] : m_entries) {
+        entries.push(matjson::makeObject({
+            { "path", path },
+            { "size", stored.size },
+            { "modified-at", stored.modifiedAt },
+            { "mod.json", stored.entry.modJson },
+            { "about.md", optionalValue(stored.entry.details) },
+            { "changelog.md", optionalValue(stored.entry.changelog) },
+            { "support.md", optionalValue(stored.entry.supportInfo) },
+        }));
+    }
+
+    auto json = matjson::makeObject({
+        { "format", INDEX_FORMAT },
+        { "loader", Loader::get()->getVersion().toVString() },
+        { "entries", std::move(entries) },
+    });
+    GEODE_UNWRAP(file::writeStringSafe(m_path, json.dump(matjson::NO_INDENTATION)));
+    m_dirty = false;
+    return Ok();
+}
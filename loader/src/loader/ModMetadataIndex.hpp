@@ -0,0 +1,45 @@
+#pragma once
+
+#include <Geode/loader/ModMetadata.hpp>
+#include <Geode/utils/StringMap.hpp>
+#include <matjson.hpp>
+#include <filesystem>
+#include <mutex>
+#include <optional>
+
+namespace geode {
+    // On-disk cache of what ModMetadata needs from a .geode file, so unchanged
+    // packages do not have to be opened on every launch. Entries are keyed by
+    // path and only used if the size and modification time still match.
+    class ModMetadataIndex final {
+    public:
+        struct Entry {
+            matjson::Value modJson;
+            std::optional<std::string> details;
+            std::optional<std::string> changelog;
+            std::optional<std::string> supportInfo;
+        };
+
+        // Missing or outdated index files just give an empty index
+        explicit ModMetadataIndex(std::filesystem::path path);
+        // Only writes if something changed, and drops entries that were not used since loading
+        Result<> save();
+
+        // These are thread safe
+        std::optional<Entry> find(std::filesystem::path const& geodeFile);
+        void insert(std::filesystem::path const& geodeFile, Entry entry);
+
+    private:
+        struct Stored {
+            uint64_t size = 0;
+            int64_t modifiedAt = 0;
+            Entry entry;
+            bool used = false;
+        };
+
+        std::filesystem::path m_path;
+        utils::StringMap<Stored> m_entries;
+        std::mutex m_mutex;
+        bool m_dirty = false;
+    };
+}
@@ -1,5 +1,6 @@
 #include "PatchImpl.hpp"
 
+#include <algorithm>
 #include <utility>
 #include "LoaderImpl.hpp"
 
@@ -46,49 +47,139 @@ std::vector<Patch::Impl*>& Patch::Impl::allEnabled() {
     return vec;
 }
 
-Result<> Patch::Impl::enable() {
-    if (m_enabled) {
+namespace {
+    struct MemoryWrite {
+        uintptr_t address;
+        ByteSpan bytes;
+    };
+
+    // Grouping only needs to agree with the real page size on where pages
+    // start, and every platform's page size is a multiple of this
+    constexpr uintptr_t PAGE_GRANULARITY = 0x1000;
+
+    // Writes that start on the same page are merged into a single chunk, with
+    // the bytes in between rewritten with what is already there, so that
+    // every page only goes through tulip's protect-write-flush once
+    Result<> writeGrouped(std::vector<MemoryWrite> writes) {
+        // stable, so that a patch being disabled is written before one being enabled at the same address
+        std::stable_sort(writes.begin(), writes.end(), [](auto const& a, auto const& b) {
+            return a.address < b.address;
+        });
+
+        struct Chunk {
+            uintptr_t address;
+            ByteVector bytes;
+        };
+        std::vector<Chunk> chunks;
+        for (auto const& write : writes) {
+            if (chunks.empty() || (chunks.back().address & ~(PAGE_GRANULARITY - 1)) != (write.address & ~(PAGE_GRANULARITY - 1))) {
+                chunks.push_back({ write.address, {} });
+            }
+            auto& chunk = chunks.back();
+            auto offset = write.address - chunk.address;
+            if (chunk.bytes.size() < offset) {
+                auto gap = readMemory(reinterpret_cast<void*>(chunk.address + chunk.bytes.size()), offset - chunk.bytes.size());
+                chunk.bytes.insert(chunk.bytes.end(), gap.begin(), gap.end());
+            }
+            if (chunk.bytes.size() < offset + write.bytes.size()) {
+                chunk.bytes.resize(offset + write.bytes.size());
+            }
+            std::copy(write.bytes.begin(), write.bytes.end(), chunk.bytes.begin() + offset);
+        }
+
+        std::vector<ByteVector> previous;
+        previous.reserve(chunks.size());
+        for (auto const& chunk : chunks) {
+            previous.push_back(readMemory(reinterpret_cast<void*>(chunk.address), chunk.bytes.size()));
+        }
+        for (size_t i = 0; i < chunks.size(); i++) {
+            auto res = tulip::hook::writeMemory(reinterpret_cast<void*>(chunks[i].address), chunks[i].bytes.data(), chunks[i].bytes.size());
+            if (!res) {
+                // put back what was already written
+                while (i-- > 0) {
+                    (void)tulip::hook::writeMemory(reinterpret_cast<void*>(chunks[i].address), previous[i].data(), previous[i].size());
+                }
+                return Err(res.unwrapErr());
+            }
+        }
         return Ok();
     }
+}
 
+bool Patch::Impl::overlaps(Patch::Impl const* other) const {
     auto const thisMin = this->getAddress();
     auto const thisMax = this->getAddress() + this->m_patch.size() - 1;
-    // TODO: this feels slow. can be faster
-    for (const auto& other : allEnabled()) {
-        auto const otherMin = other->getAddress();
-        auto const otherMax = other->getAddress() + other->m_patch.size() - 1;
-        bool intersects = (thisMin >= otherMin && thisMin <= otherMax) || (thisMax >= otherMin && thisMax <= otherMax);
-        if (!intersects)
-            continue;
-        return Err(
-            "Failed to enable patch: overlaps patch at {} from {}",
-            other->m_address, other->getOwner()->getID()
-        );
-    }
-    auto res = tulip::hook::writeMemory(m_address, m_patch.data(), m_patch.size());
-    if (!res) return Err("Failed to enable patch: {}", res.unwrapErr());
-    m_enabled = true;
-    allEnabled().push_back(this);
-    return Ok();
+    auto const otherMin = other->getAddress();
+    auto const otherMax = other->getAddress() + other->m_patch.size() - 1;
+    return (thisMin >= otherMin && thisMin <= otherMax) || (thisMax >= otherMin && thisMax <= otherMax);
 }
 
-Result<> Patch::Impl::disable() {
-    if (!m_enabled) {
-        return Ok();
+Result<> Patch::Impl::apply(std::span<Patch::Impl* const> enable, std::span<Patch::Impl* const> disable) {
+    auto& enabled = allEnabled();
+
+    for (auto patch : disable) {
+        if (std::find(enabled.begin(), enabled.end(), patch) == enabled.end()) {
+            return Err("Failed to disable patch: patch is already disabled");
+        }
+    }
+    for (auto it = enable.begin(); it != enable.end(); ++it) {
+        // TODO: this feels slow. can be faster
+        for (auto const& other : enabled) {
+            if (!(*it)->overlaps(other) || std::find(disable.begin(), disable.end(), other) != disable.end())
+                continue;
+            return Err(
+                "Failed to enable patch: overlaps patch at {} from {}",
+                other->m_address, other->getOwner()->getID()
+            );
+        }
+        for (auto other = enable.begin(); other != it; ++other) {
+            if (!(*it)->overlaps(*other))
+                continue;
+            return Err(
+                "Failed to enable patch: overlaps patch at {} from {}",
+                (*other)->m_address, (*other)->getOwner()->getID()
+            );
+        }
     }
 
-    auto res = tulip::hook::writeMemory(m_address, m_original.data(), m_original.size());
-    if (!res) return Err("Failed to disable patch: {}", res.unwrapErr());
+    std::vector<MemoryWrite> writes;
+    writes.reserve(enable.size() + disable.size());
+    for (auto patch : disable) {
+        writes.push_back({ patch->getAddress(), patch->m_original });
+    }
+    for (auto patch : enable) {
+        writes.push_back({ patch->getAddress(), patch->m_patch });
+    }
+    auto res = writeGrouped(std::move(writes));
+    if (!res) {
+        return Err("Failed to {} patch: {}", enable.empty() ? "disable" : "enable", res.unwrapErr());
+    }
 
-    m_enabled = false;
-    auto it = std::find(allEnabled().begin(), allEnabled().end(), this);
+    for (auto patch : disable) {
+        patch->m_enabled = false;
+        enabled.erase(std::find(enabled.begin(), enabled.end(), patch));
+    }
+    for (auto patch : enable) {
+        patch->m_enabled = true;
+        enabled.push_back(patch);
+    }
+    return Ok();
+}
 
-    if (it == allEnabled().end()) {
-        return Err("Failed to disable patch: patch is already disabled");
+Result<> Patch::Impl::enable() {
+    if (m_enabled) {
+        return Ok();
     }
+    Patch::Impl* self = this;
+    return apply({ &self, 1 }, {});
+}
 
-    allEnabled().erase(it);
-    return Ok();
+Result<> Patch::Impl::disable() {
+    if (!m_enabled) {
+        return Ok();
+    }
+    Patch::Impl* self = this;
+    return apply({}, { &self, 1 });
 }
 
 Result<> Patch::Impl::toggle() {
@@ -5,6 +5,7 @@
 #include <Geode/loader/Mod.hpp>
 #include "ModImpl.hpp"
 #include "ModPatch.hpp"
+#include <span>
 
 using namespace geode::prelude;
 
@@ -21,6 +22,10 @@ public:
     ByteVector m_original;
     ByteVector m_patch;
 
+    // Writes every patch in both lists at once, grouped by page. Either all
+    // of them are applied or none are
+    static Result<> apply(std::span<Patch::Impl* const> enable, std::span<Patch::Impl* const> disable);
+
     Result<> enable();
     Result<> disable();
     Result<> toggle();
@@ -30,6 +35,7 @@ public:
     Result<> updateBytes(ByteSpan bytes);
 
     uintptr_t getAddress() const;
+    bool overlaps(Patch::Impl const* other) const;
     matjson::Value getRuntimeInfo() const;
 
     friend class Patch;
@@ -1,11 +1,118 @@
 #include <cocos2d.h>
 #include <Geode/loader/ModEvent.hpp>
 #include <Geode/ui/NodeEvent.hpp>
+#include "EventImpl.hpp"
+#include <array>
+#include <memory>
 
 using namespace geode::prelude;
 
+namespace {
+    using NodeEventFilter = Event<NodeEvent, bool(), CCNode*, NodeEventType>::FilterType;
+    using AnyNodeEvent = Event<NodeEvent, bool(CCNode*, NodeEventType)>;
+    using AnyNodeEventFilter = AnyNodeEvent::FilterType;
+    using MenuItemActivatedFilter = MenuItemActivatedEvent::FilterType;
+
+    constexpr uint8_t MENU_ITEM_ACTIVATED_BIT = 1 << 7;
+    constexpr size_t NODE_EVENT_TYPE_COUNT = static_cast<size_t>(NodeEventType::OnCleanup) + 1;
+
+    // Keeps track of which nodes have node event listeners, so the script engine
+    // can skip sending events that nobody listens to. Only listeners added on
+    // the main thread are tracked, since that is the only thread they fire on.
+    struct NodeEventInterest {
+        struct Node {
+            uint8_t bits = 0;
+            // one per node event type that has listeners on this node, so sending
+            // one doesn't have to look the port up again. Shared so that a send
+            // keeps its channel alive if a listener removes the last one
+            std::array<std::shared_ptr<NodeEvent::Channel>, NODE_EVENT_TYPE_COUNT> channels;
+        };
+
+        std::atomic_size_t m_anyNodeListeners = 0;
+        std::atomic_size_t m_nodeListeners = 0;
+        // Only ever compared against, dead nodes just stay here until their
+        // listeners are removed
+        std::unordered_map<CCNode*, Node> m_nodes;
+
+        void update(CCNode* node, uint8_t bit, bool added) {
+            if (added) {
+                m_nodes[node].bits |= bit;
+                m_nodeListeners++;
+            }
+            else if (auto it = m_nodes.find(node); it != m_nodes.end()) {
+                it->second.bits &= ~bit;
+                if (it->second.bits == 0) {
+                    m_nodes.erase(it);
+                }
+                if (m_nodeListeners > 0) {
+                    m_nodeListeners--;
+                }
+            }
+        }
+
+        void updateNodeEvent(CCNode* node, NodeEventType type, bool added) {
+            auto index = static_cast<size_t>(type);
+            this->update(node, 1 << index, added);
+            if (auto it = m_nodes.find(node); it != m_nodes.end()) {
+                auto& channel = it->second.channels[index];
+                if (!added) {
+                    channel.reset();
+                }
+                else if (!channel) {
+                    channel = std::make_shared<NodeEvent::Channel>(node, type);
+                }
+            }
+        }
+
+        bool hasBit(CCNode* node, uint8_t bit) const {
+            if (m_nodeListeners == 0) return false;
+            auto it = m_nodes.find(node);
+            return it != m_nodes.end() && (it->second.bits & bit);
+        }
+
+        std::shared_ptr<NodeEvent::Channel> getChannel(CCNode* node, NodeEventType type) const {
+            if (m_nodeListeners == 0) return nullptr;
+            auto it = m_nodes.find(node);
+            if (it == m_nodes.end()) return nullptr;
+            return it->second.channels[static_cast<size_t>(type)];
+        }
+
+        bool hasMenuItemListeners(CCMenuItem* item) const {
+            return this->hasBit(item, MENU_ITEM_ACTIVATED_BIT);
+        }
+    };
+
+    NodeEventInterest s_interest;
+}
+
+$execute {
+    comm::addPortObserver([](comm::BaseFilter const* filter, bool added) {
+        // the global event center calls this from any thread, and other threads
+        // only get here through a center they share with the main thread by mistake
+        if (!comm::isMainEventThread()) return;
+        if (auto nodeFilter = typeinfo_cast<NodeEventFilter const*>(filter)) {
+            auto [node, type] = nodeFilter->getFilter();
+            s_interest.updateNodeEvent(node, type, added);
+        }
+        else if (auto itemFilter = typeinfo_cast<MenuItemActivatedFilter const*>(filter)) {
+            s_interest.update(std::get<0>(itemFilter->getFilter()), MENU_ITEM_ACTIVATED_BIT, added);
+        }
+        else if (typeinfo_cast<AnyNodeEventFilter const*>(filter)) {
+            if (added) {
+                s_interest.m_anyNodeListeners++;
+            }
+            // the port may have been made before the observer was added
+            else if (s_interest.m_anyNodeListeners > 0) {
+                s_interest.m_anyNodeListeners--;
+            }
+        }
+    });
+}
+
 namespace geode {
     class ScriptEngine : public CCScriptEngineProtocol {
+        NodeEvent::Channel m_nodeEventChannel;
+        AnyNodeEvent::Channel m_anyNodeEventChannel = AnyNodeEvent().channel();
 
         ccScriptType getScriptType() {
             // Javascript engine is called without needing to change m_nLuaID
@@ -13,11 +120,24 @@ namespace geode {
         }
         
         int executeNodeEvent(CCNode* node, int action) {
-            NodeEvent(node, static_cast<NodeEventType>(action)).send();
+            auto type = static_cast<NodeEventType>(action);
+            if (!comm::EventCenter::get()->isEmpty()) {
+                // listeners in the old event center aren't tracked
+                m_nodeEventChannel.send(node, type);
+            }
+            else if (auto channel = s_interest.getChannel(node, type)) {
+                channel->send();
+            }
+            else if (s_interest.m_anyNodeListeners > 0) {
+                m_anyNodeEventChannel.send(node, type);
+            }
             return -1;
         }
 
         int executeMenuItemEvent(CCMenuItem* menuItem) {
+            if (!s_interest.hasMenuItemListeners(menuItem) && comm::EventCenter::get()->isEmpty()) {
+                return -1;
+            }
             MenuItemActivatedEvent(menuItem).send(menuItem);
             return -1;
         }
@@ -0,0 +1,197 @@
+#include "SpritesheetCache.hpp"
+#include <Geode/utils/cocos.hpp>
+#include <Geode/utils/file.hpp>
+#include <Geode/loader/Log.hpp>
+#include <utils/cache.hpp>
+#include <cstdlib>
+
+using namespace geode::prelude;
+
+namespace {
+    constexpr uint32_t FRAMES_MAGIC = 0x53465347; // "GSFS"
+
+    char const* stringFor(CCDictionary* dict, char const* key) {
+        // valueForKey autoreleases an empty string for missing keys, which
+        // isn't safe off the main thread
+        auto str = typeinfo_cast<CCString*>(dict->objectForKey(key));
+        return str ? str->getCString() : "";
+    }
+
+    bool boolFor(CCDictionary* dict, char const* key) {
+        std::string_view str = stringFor(dict, key);
+        return !str.empty() && str != "0" && str != "false";
+    }
+
+    // Mirrors CCSpriteFrameCache::addSpriteFramesWithDictionary
+    Result<std::vector<CachedSpriteFrame>> parseSpriteFrames(std::string const& plist) {
+        auto dict = Ref<CCDictionary>::adopt(CCDictionary::createWithContentsOfFileThreadSafe(plist.c_str()));
+        if (!dict) {
+            return Err("Unable to parse {}", plist);
+        }
+
+        int format = 0;
+        if (auto metadata = typeinfo_cast<CCDictionary*>(dict->objectForKey("metadata"))) {
+            format = std::atoi(stringFor(metadata, "format"));
+        }
+        if (format < 0 || format > 3) {
+            return Err("Unsupported spritesheet format {} in {}", format, plist);
+        }
+
+        auto framesDict = typeinfo_cast<CCDictionary*>(dict->objectForKey("frames"));
+        if (!framesDict) {
+            return Err("{} has no frames", plist);
+        }
+
+        std::vector<CachedSpriteFrame> frames;
+        frames.reserve(framesDict->count());
+        CCDictElement* element;
+        CCDICT_FOREACH(framesDict, element) {
+            auto frameDict = typeinfo_cast<CCDictionary*>(element->getObject());
+            if (!frameDict) continue;
+
+            auto& frame = frames.emplace_back();
+            frame.name = element->getStrKey();
+            if (format == 0) {
+                frame.rect = CCRect(
+                    std::atof(stringFor(frameDict, "x")), std::atof(stringFor(frameDict, "y")),
+                    std::atof(stringFor(frameDict, "width")), std::atof(stringFor(frameDict, "height"))
+                );
+                frame.offset = CCPoint(
+                    std::atof(stringFor(frameDict, "offsetX")), std::atof(stringFor(frameDict, "offsetY"))
+                );
+                frame.originalSize = CCSize(
+                    std::abs(std::atoi(stringFor(frameDict, "originalWidth"))),
+                    std::abs(std::atoi(stringFor(frameDict, "originalHeight")))
+                );
+            }
+            else if (format == 1 || format == 2) {
+                frame.rect = CCRectFromString(stringFor(frameDict, "frame"));
+                frame.rotated = format == 2 && boolFor(frameDict, "rotated");
+                frame.offset = CCPointFromString(stringFor(frameDict, "offset"));
+                frame.originalSize = CCSizeFromString(stringFor(frameDict, "sourceSize"));
+            }
+            else {
+                auto size = CCSizeFromString(stringFor(frameDict, "spriteSize"));
+                auto textureRect = CCRectFromString(stringFor(frameDict, "textureRect"));
+                frame.rect = CCRect(textureRect.origin.x, textureRect.origin.y, size.width, size.height);
+                frame.rotated = boolFor(frameDict, "textureRotated");
+                frame.offset = CCPointFromString(stringFor(frameDict, "spriteOffset"));
+                frame.originalSize = CCSizeFromString(stringFor(frameDict, "spriteSourceSize"));
+                if (auto aliases = typeinfo_cast<CCArray*>(frameDict->objectForKey("aliases"))) {
+                    for (auto alias : CCArrayExt<CCString*>(aliases)) {
+                        frame.aliases.emplace_back(alias->getCString());
+                    }
+                }
+            }
+        }
+        return Ok(std::move(frames));
+    }
+
+    void writeFrames(cache::Writer& writer, std::span<CachedSpriteFrame const> frames) {
+        writer.write(static_cast<uint32_t>(frames.size()));
+        for (auto const& frame : frames) {
+            writer.writeString(frame.name);
+            writer.write(frame.rect.origin.x);
+            writer.write(frame.rect.origin.y);
+            writer.write(frame.rect.size.width);
+            writer.write(frame.rect.size.height);
+            writer.write(frame.offset.x);
+            writer.write(frame.offset.y);
+            writer.write(frame.originalSize.width);
+            writer.write(frame.originalSize.height);
+            writer.write(static_cast<uint8_t>(frame.rotated));
+            writer.write(static_cast<uint32_t>(frame.aliases.size()));
+            for (auto const& alias : frame.aliases) {
+                writer.writeString(alias);
+            }
+        }
+    }
+
+    std::optional<std::vector<CachedSpriteFrame>> readFrames(cache::Reader& reader) {
+        uint32_t count;
+        if (!reader.read(count)) return std::nullopt;
+
+        std::vector<CachedSpriteFrame> frames;
+        frames.reserve(count);
+        for (uint32_t i = 0; i < count; i++) {
+            auto& frame = frames.emplace_back();
+            std::string_view name;
+            uint8_t rotated;
+            uint32_t aliasCount;
+            if (
+                !reader.readString(name) ||
+                !reader.read(frame.rect.origin.x) || !reader.read(frame.rect.origin.y) ||
+                !reader.read(frame.rect.size.width) || !reader.read(frame.rect.size.height) ||
+                !reader.read(frame.offset.x) || !reader.read(frame.offset.y) ||
+                !reader.read(frame.originalSize.width) || !reader.read(frame.originalSize.height) ||
+                !reader.read(rotated) || !reader.read(aliasCount)
+            ) return std::nullopt;
+
+            frame.name = name;
+            frame.rotated = rotated;
+            frame.aliases.reserve(aliasCount);
+            for (uint32_t j = 0; j < aliasCount; j++) {
+                std::string_view alias;
+                if (!reader.readString(alias)) return std::nullopt;
+                frame.aliases.emplace_back(alias);
+            }
+        }
+        if (!reader.done()) return std::nullopt;
+        return frames;
+    }
+}
+
+Result<std::vector<CachedSpriteFrame>> geode::loadSpriteFrames(std::string const& plist) {
+    auto stamp = cache::stampOf(plist);
+    auto cachePath = cache::pathFor(plist, ".frames");
+
+    std::optional<Sha256> hash;
+    auto hashSource = [&]() -> std::optional<Sha256> {
+        if (!hash) {
+            auto source = file::readBinary(plist);
+            if (!source) return std::nullopt;
+            hash = sha256(source.unwrap());
+        }
+        return hash;
+    };
+
+    if (auto body = cache::read(cachePath, FRAMES_MAGIC, stamp, hashSource)) {
+        cache::Reader reader(*body);
+        if (auto frames = readFrames(reader)) {
+            return Ok(std::move(*frames));
+        }
+    }
+
+    GEODE_UNWRAP_INTO(auto frames, parseSpriteFrames(plist));
+    if (auto source = hashSource()) {
+        cache::Writer writer;
+        writeFrames(writer, frames);
+        if (auto res = cache::write(cachePath, FRAMES_MAGIC, stamp, *source, writer.data()); !res) {
+            log::warn("Unable to cache frames of {}: {}", plist, res.unwrapErr());
+        }
+    }
+    return Ok(std::move(frames));
+}
+
+void geode::addSpriteFrames(std::span<CachedSpriteFrame const> frames, CCTexture2D* texture) {
+    auto frameCache = CCSpriteFrameCache::get();
+    for (auto const& frame : frames) {
+        // like cocos, frames that are already registered are left alone
+        if (frameCache->m_pSpriteFrames->objectForKey(frame.name)) continue;
+
+        if (!frame.aliases.empty()) {
+            auto key = CCString::create(frame.name);
+            for (auto const& alias : frame.aliases) {
+                if (frameCache->m_pSpriteFramesAliases->objectForKey(alias)) {
+                    log::warn("Sprite frame alias {} is already taken", alias);
+                }
+                frameCache->m_pSpriteFramesAliases->setObject(key, alias);
+            }
+        }
+
+        auto spriteFrame = CCSpriteFrame::createWithTexture(
+            texture, frame.rect, frame.rotated, frame.offset, frame.originalSize
+        );
+        frameCache->m_pSpriteFrames->setObject(spriteFrame, frame.name);
+    }
+}
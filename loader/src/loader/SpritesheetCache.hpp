@@ -0,0 +1,28 @@
+#pragma once
+
+#include <cocos2d.h>
+#include <Geode/Result.hpp>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace geode {
+    // A sprite frame as described by a spritesheet plist, in pixels
+    struct CachedSpriteFrame {
+        std::string name;
+        cocos2d::CCRect rect;
+        cocos2d::CCPoint offset;
+        cocos2d::CCSize originalSize;
+        bool rotated = false;
+        std::vector<std::string> aliases;
+    };
+
+    // Reads the frames of a spritesheet plist from its binary cache, parsing the
+    // plist and writing the cache if it's missing or outdated. Safe to call off
+    // the main thread
+    Result<std::vector<CachedSpriteFrame>> loadSpriteFrames(std::string const& plist);
+
+    // Registers the frames to the sprite frame cache the same way
+    // CCSpriteFrameCache::addSpriteFramesWithFile does. Main thread only
+    void addSpriteFrames(std::span<CachedSpriteFrame const> frames, cocos2d::CCTexture2D* texture);
+}
@@ -6,8 +6,14 @@
 #include <utility>
 #include "LoaderImpl.hpp"
 #include "ModMetadataImpl.hpp"
+#include <Geode/loader/Dirs.hpp>
+#include <Geode/utils/async.hpp>
+#include <Geode/utils/file.hpp>
 #include <Geode/utils/string.hpp>
 #include <Geode/utils/StringMap.hpp>
+#include <Geode/utils/trace.hpp>
+#include <atomic>
+#include <future>
 
 #include "../server/Server.hpp"
 
@@ -173,64 +179,188 @@ void updater::downloadLoaderResources(bool useLatestRelease) {
 
 }
 
-bool updater::verifyLoaderResources() {
-    static std::optional<bool> CACHED = std::nullopt;
-    if (CACHED.has_value()) {
-        return CACHED.value();
-    }
+namespace {
+    // Hashes of the resource files as of the last launch, so that files
+    // that haven't changed since then don't have to be hashed again
+    struct ResourceHashCache {
+        struct Entry {
+            uint64_t size;
+            int64_t modifiedAt;
+            std::string hash;
+        };
+        StringMap<Entry> entries;
+
+        static std::filesystem::path path() {
+            return dirs::getTempDir() / "resource-hashes.json";
+        }
 
-    // geode/resources/geode.loader
-    auto resourcesDir = dirs::getGeodeResourcesDir() / Mod::get()->getID();
+        static ResourceHashCache load() {
+            ResourceHashCache cache;
+            auto res = file::readJson(path());
+            if (!res) return cache;
+            for (auto const& item : res.unwrap()) {
+                auto name = item["name"].asString();
+                auto size = item["size"].asUInt();
+                auto modifiedAt = item["modified-at"].asInt();
+                auto hash = item["sha256"].asString();
+                if (!name || !size || !modifiedAt || !hash) continue;
+                cache.entries.insert_or_assign(std::move(name).unwrap(), Entry {
+                    .size = static_cast<uint64_t>(size.unwrap()),
+                    .modifiedAt = static_cast<int64_t>(modifiedAt.unwrap()),
+                    .hash = std::move(hash).unwrap(),
+                });
+            }
+            return cache;
+        }
 
-    // if the resources dir doesn't exist, then it's probably incorrect
-    if (!(
-        std::filesystem::exists(resourcesDir) &&
-            std::filesystem::is_directory(resourcesDir)
-    )) {
-        log::debug("Resources directory does not exist");
-        updater::downloadLoaderResources(true);
-        return false;
-    }
+        Result<> save() const {
+            auto json = matjson::Value::array();
+            for (auto const& [name, entry] : entries) {
+                json.push(matjson::makeObject({
+                    { "name", name },
+                    { "size", entry.size },
+                    { "modified-at", entry.modifiedAt },
+                    { "sha256", entry.hash },
+                }));
+            }
+            return file::writeStringSafe(path(), json.dump(matjson::NO_INDENTATION));
+        }
+    };
 
-    // TODO: actually have a proper way to disable checking resources
-    // for development builds
-    if (std::filesystem::exists(resourcesDir / "dont-update.txt")) {
-        // this is kind of a hack, but it's the easiest way to prevent
-        // auto update while developing
-        log::debug("Not updating resources since dont-update.txt exists");
-        return true;
-    }
+    updater::ResourceVerification checkLoaderResources() {
+        using updater::ResourceVerification;
+        trace::Span span("Verifying loader resources");
 
-    // make sure every file was covered
-    size_t coverage = 0;
+        // geode/resources/geode.loader
+        auto resourcesDir = dirs::getGeodeResourcesDir() / Mod::get()->getID();
 
-    // verify hashes
-    for (auto& file : std::filesystem::directory_iterator(resourcesDir)) {
-        auto name = utils::string::pathToString(file.path().filename());
-        // skip unknown files
-        if (!LOADER_RESOURCE_HASHES.count(name)) {
-            continue;
+        // if the resources dir doesn't exist, then it's probably incorrect
+        if (!(
+            std::filesystem::exists(resourcesDir) &&
+                std::filesystem::is_directory(resourcesDir)
+        )) {
+            log::debug("Resources directory does not exist");
+            return ResourceVerification::Missing;
         }
-        // verify hash
-        // if we hash anything other than text, change this
-        auto hash = sha256Text(file.path()).toString();
-        const auto& expected = LOADER_RESOURCE_HASHES.at(name);
-        if (hash != expected) {
-            log::debug("Resource hash mismatch: {} ({}, {})", name, hash.substr(0, 7), expected.substr(0, 7));
-            updater::downloadLoaderResources();
-            return false;
+
+        // TODO: actually have a proper way to disable checking resources
+        // for development builds
+        if (std::filesystem::exists(resourcesDir / "dont-update.txt")) {
+            // this is kind of a hack, but it's the easiest way to prevent
+            // auto update while developing
+            log::debug("Not updating resources since dont-update.txt exists");
+            return ResourceVerification::Valid;
+        }
+
+        struct Resource {
+            std::string name;
+            std::filesystem::path path;
+            ResourceHashCache::Entry stamp;
+            bool cached = false;
+        };
+        std::vector<Resource> resources;
+        for (auto& file : std::filesystem::directory_iterator(resourcesDir)) {
+            auto name = utils::string::pathToString(file.path().filename());
+            // skip unknown files
+            if (!LOADER_RESOURCE_HASHES.count(name)) {
+                continue;
+            }
+            std::error_code ec;
+            auto size = std::filesystem::file_size(file.path(), ec);
+            auto modifiedAt = std::filesystem::last_write_time(file.path(), ec);
+            resources.push_back(Resource {
+                .name = std::move(name),
+                .path = file.path(),
+                .stamp = {
+                    .size = ec ? 0 : static_cast<uint64_t>(size),
+                    .modifiedAt = ec ? 0 : static_cast<int64_t>(modifiedAt.time_since_epoch().count()),
+                },
+            });
+        }
+
+        // make sure every file was found
+        if (resources.size() != LOADER_RESOURCE_HASHES.size()) {
+            log::debug("Resource coverage mismatch");
+            return ResourceVerification::Outdated;
         }
-        coverage += 1;
-    }
 
-    // make sure every file was found
-    if (coverage != LOADER_RESOURCE_HASHES.size()) {
-        log::debug("Resource coverage mismatch");
-        updater::downloadLoaderResources();
-        return false;
+        // hash whatever changed since the last launch in parallel
+        auto cache = ResourceHashCache::load();
+        std::atomic_size_t remaining = 0;
+        for (auto& resource : resources) {
+            auto it = cache.entries.find(resource.name);
+            if (
+                it != cache.entries.end() &&
+                it->second.size == resource.stamp.size &&
+                it->second.modifiedAt == resource.stamp.modifiedAt
+            ) {
+                resource.stamp.hash = it->second.hash;
+                resource.cached = true;
+                continue;
+            }
+            remaining.fetch_add(1, std::memory_order::relaxed);
+            async::spawnBlocking(async::BlockingLane::CPU, [&] {
+                // if we hash anything other than text, change this
+                resource.stamp.hash = sha256Text(resource.path).toString();
+                if (remaining.fetch_sub(1, std::memory_order::acq_rel) == 1) {
+                    remaining.notify_all();
+                }
+            });
+        }
+        for (auto left = remaining.load(std::memory_order::acquire); left != 0; left = remaining.load(std::memory_order::acquire)) {
+            remaining.wait(left, std::memory_order::acquire);
+        }
+
+        // verify hashes
+        bool rehashed = false;
+        for (auto& resource : resources) {
+            auto const& expected = LOADER_RESOURCE_HASHES.at(resource.name);
+            if (resource.stamp.hash != expected) {
+                log::debug("Resource hash mismatch: {} ({}, {})", resource.name, resource.stamp.hash.substr(0, 7), expected.substr(0, 7));
+                return ResourceVerification::Outdated;
+            }
+            rehashed |= !resource.cached;
+            // files whose size or time couldn't be read are never cached
+            if (resource.stamp.modifiedAt != 0) {
+                cache.entries.insert_or_assign(resource.name, std::move(resource.stamp));
+            }
+        }
+
+        // only valid hashes are cached, a mismatch is going to replace the files anyway
+        if (rehashed) {
+            if (auto res = cache.save(); !res) {
+                log::warn("Unable to save resource hashes: {}", res.unwrapErr());
+            }
+        }
+
+        return ResourceVerification::Valid;
     }
+}
+
+std::shared_future<updater::ResourceVerification> updater::verifyLoaderResourcesAsync() {
+    static std::shared_future<ResourceVerification> VERIFICATION = [] {
+        auto promise = std::make_shared<std::promise<ResourceVerification>>();
+        auto future = promise->get_future().share();
+        async::spawnBlocking(async::BlockingLane::IO, [promise] {
+            promise->set_value(checkLoaderResources());
+        });
+        return future;
+    }();
+    return VERIFICATION;
+}
 
-    return true;
+bool updater::verifyLoaderResources() {
+    switch (verifyLoaderResourcesAsync().get()) {
+        case ResourceVerification::Valid:
+            return true;
+        case ResourceVerification::Missing:
+            updater::downloadLoaderResources(true);
+            return false;
+        case ResourceVerification::Outdated:
+        default:
+            updater::downloadLoaderResources();
+            return false;
+    }
 }
 
 void updater::downloadLoaderUpdate(std::string url) {
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <future>
 #include <string>
 #include <matjson.hpp>
 #include <Geode/loader/Event.hpp>
@@ -31,6 +32,17 @@ namespace geode::updater {
     void downloadLatestLoaderResources();
     void downloadLoaderUpdate(std::string url);
 
+    enum class ResourceVerification {
+        Valid,
+        Missing,
+        Outdated,
+    };
+
+    // Starts verifying the loader resources on a worker thread the first time
+    // it's called, every call after that returns the same future
+    std::shared_future<ResourceVerification> verifyLoaderResourcesAsync();
+    // Waits for verifyLoaderResourcesAsync and starts downloading the resources
+    // if they are not valid
     bool verifyLoaderResources();
     void checkForLoaderUpdates();
     bool isNewUpdateDownloaded();
@@ -20,7 +20,8 @@ public:
     DownloadStatus m_status;
     async::TaskHolder<web::WebResponse> m_downloadListener;
     async::TaskHolder<ServerResult<ServerModVersion>> m_infoListener;
-    unsigned int m_scheduledEventForFrame = 0;
+    // sends ModDownloadEvent at most once per frame, no matter how often the status changes
+    async::ProgressSlot<std::monostate> m_statusChanged;
 
     Impl(
         std::string id,
@@ -34,6 +35,9 @@ public:
         m_replacesMod(std::move(replacesMod)),
         m_status(DownloadStatusFetching {
             .percentage = 0,
+        }),
+        m_statusChanged([id = m_id](std::monostate) {
+            ModDownloadEvent(std::string(id)).send();
         })
     {
         auto fetchVersion = version.has_value() ? ModVersion(*version) : ModVersion(ModVersionLatest());
@@ -64,15 +68,11 @@ public:
                     };
                 }
 
-                Loader::get()->queueInMainThread([id = m_id]() {
-                    ModDownloadEvent(std::string(id)).send();
-                });
+                m_statusChanged.post({});
             }
         );
 
-        Loader::get()->queueInMainThread([id = m_id] {
-            ModDownloadEvent(std::string(id)).send();
-        });
+        m_statusChanged.post({});
     }
 
     void onFinished(web::WebResponse response, ServerModVersion version) {
@@ -166,31 +166,22 @@ public:
         };
 
         auto req = web::WebRequest().userAgent(getServerUserAgent());
-        req.onProgress([this, id = std::string(m_id)](const auto& progress) {
+        req.onProgress([this](const auto& progress) {
             m_status = DownloadStatusDownloading {
                 .percentage = static_cast<uint8_t>(progress.downloadProgress().value_or(0)),
             };
-            ModDownloadEvent(id).send();
+            m_statusChanged.post({});
         });
 
         m_downloadListener.spawn(
             req.get(std::move(downloadURL)),
             [this, version = std::move(version)](web::WebResponse response) mutable {
                 this->onFinished(std::move(response), std::move(version));
-
-                // post event
-                if (m_scheduledEventForFrame != CCDirector::get()->getTotalFrames()) {
-                    m_scheduledEventForFrame = CCDirector::get()->getTotalFrames();
-                    Loader::get()->queueInMainThread([id = m_id]() {
-                        ModDownloadEvent(std::string(id)).send();
-                    });
-                }
+                m_statusChanged.post({});
             }
         );
 
-        Loader::get()->queueInMainThread([id = m_id]() {
-            ModDownloadEvent(std::string(id)).send();
-        });
+        m_statusChanged.post({});
     }
 };
 
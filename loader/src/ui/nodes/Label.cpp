@@ -5,12 +5,15 @@
 #include <Geode/utils/file.hpp>
 #include <asp/collections/SmallVec.hpp>
 #include <simdutf/implementation.h>
+#include <utils/cache.hpp>
 
 #include <numeric>
 #include <ranges>
 
 using namespace geode::prelude;
 
+static constexpr uint32_t FONT_CACHE_MAGIC = 0x54464E47; // "GNFT"
+
 static StringMap<BitmapFont>& GetBitmapFontsCache() {
     static StringMap<BitmapFont> cache;
     return cache;
@@ -68,28 +71,49 @@ static void forEachPair(std::string_view line, F&& fn) {
 }
 
 bool BitmapFont::initWithFile(ZStringView fntFile) {
+    m_fntFilename = fntFile;
+
+    std::string fullPath = CCFileUtils::get()->fullPathForFilename(fntFile.c_str(), false);
+    auto cachePath = cache::pathFor(fntFile.view(), ".fnt");
+
+    // the .fnt is only read if the cache can't be trusted by its stamp alone
+    std::optional<std::string> contents;
+    auto loadContents = [&] {
+        if (contents) return true;
 #if defined(GEODE_IS_MOBILE) || !defined(NDEBUG)
-    unsigned long size = 0;
-    uint8_t* data = CCFileUtils::get()->getFileData(fntFile.c_str(), "rb", &size);
-    if (!data || !size) {
-        return false;
-    }
+        unsigned long size = 0;
+        uint8_t* data = CCFileUtils::get()->getFileData(fntFile.c_str(), "rb", &size);
+        if (!data || !size) {
+            return false;
+        }
 
-    std::unique_ptr<uint8_t[]> buffer(data);
-    auto contents = std::string_view(reinterpret_cast<char*>(data), size);
+        std::unique_ptr<uint8_t[]> buffer(data);
+        contents.emplace(reinterpret_cast<char*>(data), size);
 #else
-    auto fullPath = CCFileUtils::get()->fullPathForFilename(fntFile.c_str(), false);
-    auto res = file::readString(fullPath);
-    if (res.isErr()) {
-        return false;
-    }
+        auto res = file::readString(fullPath);
+        if (res.isErr()) {
+            return false;
+        }
 
-    auto contents = std::move(res).unwrap();
+        contents = std::move(res).unwrap();
 #endif
+        return true;
+    };
 
-    m_fntFilename = fntFile;
+    std::optional<Sha256> hash;
+    auto hashSource = [&]() -> std::optional<Sha256> {
+        if (!hash && loadContents()) {
+            hash = sha256(std::string_view(*contents));
+        }
+        return hash;
+    };
+
+    auto stamp = cache::stampOf(fullPath);
+    if (auto body = cache::read(cachePath, FONT_CACHE_MAGIC, stamp, hashSource); body && this->initWithCache(*body)) {
+        return true;
+    }
 
-    if (!this->initWithContents(contents)) {
+    if (!hashSource() || !this->initWithContents(*contents)) {
         return false;
     }
 
@@ -97,9 +121,98 @@ bool BitmapFont::initWithFile(ZStringView fntFile) {
         return false;
     }
 
+    if (auto res = cache::write(cachePath, FONT_CACHE_MAGIC, stamp, *hash, this->toCache()); !res) {
+        log::warn("Unable to cache font {}: {}", fntFile, res.unwrapErr());
+    }
+
     return true;
 }
 
+bool BitmapFont::initWithCache(ByteSpan data) {
+    cache::Reader reader(data);
+
+    auto read = [&] {
+        std::string_view atlasName;
+        uint32_t charCount, kerningCount;
+        if (
+            !reader.readString(atlasName) ||
+            !reader.read(m_padding) ||
+            !reader.read(m_atlasSize.width) || !reader.read(m_atlasSize.height) ||
+            !reader.read(m_commonHeight) ||
+            !reader.read(charCount) || !reader.read(kerningCount)
+        ) return false;
+
+        auto max = CCConfiguration::sharedConfiguration()->getMaxTextureSize();
+        if (atlasName.empty() || m_atlasSize.width > max || m_atlasSize.height > max) {
+            return false;
+        }
+        m_atlasName = atlasName;
+
+        m_characters.reserve(charCount);
+        for (uint32_t i = 0; i < charCount; i++) {
+            CharDef def;
+            if (
+                !reader.read(def.codepoint) ||
+                !reader.read(def.rect.origin.x) || !reader.read(def.rect.origin.y) ||
+                !reader.read(def.rect.size.width) || !reader.read(def.rect.size.height) ||
+                !reader.read(def.xOffset) || !reader.read(def.yOffset) || !reader.read(def.xAdvance)
+            ) return false;
+            m_characters.emplace(def.codepoint, std::move(def));
+        }
+
+        m_kerning.reserve(kerningCount);
+        for (uint32_t i = 0; i < kerningCount; i++) {
+            KerningPair pair;
+            float amount;
+            if (!reader.read(pair.first) || !reader.read(pair.second) || !reader.read(amount)) {
+                return false;
+            }
+            m_kerning.emplace(pair, KerningValue{ .amount = amount });
+        }
+
+        return reader.done();
+    };
+
+    if (!read()) {
+        // leave nothing behind for the text parser
+        m_atlasName.clear();
+        m_characters.clear();
+        m_kerning.clear();
+        m_padding = {};
+        m_atlasSize = {};
+        m_commonHeight = 0.f;
+        return false;
+    }
+    return true;
+}
+
+ByteVector BitmapFont::toCache() const {
+    cache::Writer writer;
+    writer.writeString(m_atlasName);
+    writer.write(m_padding);
+    writer.write(m_atlasSize.width);
+    writer.write(m_atlasSize.height);
+    writer.write(m_commonHeight);
+    writer.write(static_cast<uint32_t>(m_characters.size()));
+    writer.write(static_cast<uint32_t>(m_kerning.size()));
+    for (auto const& def : m_characters | std::views::values) {
+        writer.write(def.codepoint);
+        writer.write(def.rect.origin.x);
+        writer.write(def.rect.origin.y);
+        writer.write(def.rect.size.width);
+        writer.write(def.rect.size.height);
+        writer.write(def.xOffset);
+        writer.write(def.yOffset);
+        writer.write(def.xAdvance);
+    }
+    for (auto const& [pair, value] : m_kerning) {
+        writer.write(pair.first);
+        writer.write(pair.second);
+        writer.write(value.amount);
+    }
+    return std::move(writer.data());
+}
+
 bool BitmapFont::initWithContents(std::string_view text) {
     for (auto line : asp::iter::lines(text)) {
         if (line.starts_with("char ")) {
@@ -142,7 +255,7 @@ bool BitmapFont::initWithContents(std::string_view text) {
                 }
             });
 
-            m_kerning.emplace(pair, KerningValue{amount, amount});
+            m_kerning.emplace(pair, KerningValue{ .amount = amount });
         } else if (line.starts_with("info ")) {
             line.remove_prefix(5);
             forEachPair(line, [&](std::string_view key, std::string_view value) {
@@ -253,7 +366,7 @@ void BitmapFont::initBakedValues() {
     }
 
     for (auto& kerning : m_kerning | std::views::values) {
-        kerning.scaled *= scale;
+        kerning.scaled = kerning.amount * scale;
     }
 
     m_commonHeightScaled = m_commonHeight * scale;
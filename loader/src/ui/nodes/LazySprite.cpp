@@ -115,7 +115,7 @@ void LazySprite::loadFromFile(const std::filesystem::path& path, Format format,
     m_impl->m_expectedFormat = format;
     m_impl->m_isLoading = true;
 
-    async::runtime().spawnBlocking<void>([
+    async::spawnBlocking(async::BlockingLane::IO, [
         selfref = WeakRef(this),
         path = path,
         cacheKey = std::move(cacheKey)
@@ -166,7 +166,7 @@ void LazySprite::loadFromData(uint8_t const* ptr, size_t size, Format format) {
 // ! This function must be invoked on main thread !
 void LazySprite::Impl::doInitFromBytes(std::vector<uint8_t> data, std::string cacheKey) {
     // do initialization in the threadpool
-    async::runtime().spawnBlocking<void>([
+    async::spawnBlocking(async::BlockingLane::CPU, [
         selfref = WeakRef(m_self),
         data = std::move(data),
         cacheKey = std::move(cacheKey),
@@ -190,6 +190,7 @@ void LazySprite::Impl::doInitFromBytes(std::vector<uint8_t> data, std::string ca
 
         // image initialization succeeded, all we need to do now is to
         // create the OpenGL texture (must be on main thread!) and then set this sprite to use that.
+        // uploads come in bursts when a list of sprites loads, so let them spill over frames
 
         Loader::get()->queueInMainThread([
             selfref = std::move(selfref),
@@ -221,7 +222,7 @@ void LazySprite::Impl::doInitFromBytes(std::vector<uint8_t> data, std::string ca
             }
 
             texture->release(); // bring texture's refcount back to 1
-        });
+        }, MainThreadPriority::Background);
     });
 }
 
@@ -3,6 +3,12 @@
 #include <Geode/loader/Log.hpp>
 #include <Geode/utils/terminate.hpp>
 #include <loader/LogImpl.hpp>
+#include <arc/time/Sleep.hpp>
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
 
 using namespace geode::prelude;
 
@@ -34,6 +40,197 @@ arc::Runtime& runtime() {
     return *ptr;
 }
 
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    struct BlockingJob {
+        Function<void()> func;
+        Clock::time_point queuedAt;
+    };
+
+    // Every worker has its own queue, spawned jobs are spread over them round robin.
+    // A worker runs its own jobs in order, and steals from the back of the others once
+    // it runs out.
+    class BlockingPool final {
+    public:
+        BlockingPool(std::string name, size_t workerCount) : m_name(std::move(name)) {
+            for (size_t i = 0; i < workerCount; ++i) {
+                m_workers.push_back(std::make_unique<Worker>());
+            }
+        }
+
+        void spawn(Function<void()> func) {
+            if (m_stopping.load(std::memory_order::acquire)) {
+                // the game is exiting, there are no threads left to run this on
+                func();
+                return;
+            }
+            std::call_once(m_started, [this] { this->start(); });
+
+            auto& worker = *m_workers[m_next.fetch_add(1, std::memory_order::relaxed) % m_workers.size()];
+            {
+                std::lock_guard lock(worker.mutex);
+                // counted under the lock, so a worker that takes the job can never
+                // decrement before this and wrap the counter around
+                m_queued.fetch_add(1, std::memory_order::release);
+                worker.jobs.push_back(BlockingJob { std::move(func), Clock::now() });
+            }
+
+            // taking the lock makes sure a worker that is about to sleep sees the new job
+            { std::lock_guard lock(m_sleepMutex); }
+            m_sleepCV.notify_one();
+        }
+
+        BlockingLaneMetrics getMetrics() const {
+            BlockingLaneMetrics metrics;
+            metrics.workers = m_workers.size();
+            metrics.queueDepth = m_queued.load(std::memory_order::relaxed);
+            metrics.active = m_active.load(std::memory_order::relaxed);
+            metrics.completed = m_completed.load(std::memory_order::relaxed);
+            for (size_t i = 0; i < BlockingLaneMetrics::BUCKET_COUNT; ++i) {
+                metrics.waitHistogram[i] = m_waitHistogram[i].load(std::memory_order::relaxed);
+                metrics.runHistogram[i] = m_runHistogram[i].load(std::memory_order::relaxed);
+            }
+            return metrics;
+        }
+
+        void shutdown() {
+            m_stopping.store(true, std::memory_order::release);
+            {
+                std::lock_guard lock(m_sleepMutex);
+            }
+            m_sleepCV.notify_all();
+            for (auto& worker : m_workers) {
+                if (worker->thread.joinable()) {
+                    worker->thread.join();
+                }
+            }
+        }
+
+    private:
+        struct Worker {
+            std::mutex mutex;
+            std::deque<BlockingJob> jobs;
+            std::thread thread;
+        };
+
+        std::string m_name;
+        std::vector<std::unique_ptr<Worker>> m_workers;
+        std::once_flag m_started;
+        std::mutex m_sleepMutex;
+        std::condition_variable m_sleepCV;
+        std::atomic_bool m_stopping = false;
+        std::atomic_size_t m_next = 0;
+        std::atomic_size_t m_queued = 0;
+        std::atomic_size_t m_active = 0;
+        std::atomic_size_t m_completed = 0;
+        std::array<std::atomic_size_t, BlockingLaneMetrics::BUCKET_COUNT> m_waitHistogram{};
+        std::array<std::atomic_size_t, BlockingLaneMetrics::BUCKET_COUNT> m_runHistogram{};
+
+        void start() {
+            for (size_t i = 0; i < m_workers.size(); ++i) {
+                m_workers[i]->thread = std::thread([this, i] {
+                    utils::thread::setName(fmt::format("{} Worker {}", m_name, i));
+                    this->run(i);
+                });
+            }
+        }
+
+        bool take(size_t index, BlockingJob& out) {
+            {
+                auto& own = *m_workers[index];
+                std::lock_guard lock(own.mutex);
+                if (!own.jobs.empty()) {
+                    out = std::move(own.jobs.front());
+                    own.jobs.pop_front();
+                    return true;
+                }
+            }
+            for (size_t i = 1; i < m_workers.size(); ++i) {
+                auto& other = *m_workers[(index + i) % m_workers.size()];
+                std::lock_guard lock(other.mutex);
+                if (!other.jobs.empty()) {
+                    out = std::move(other.jobs.back());
+                    other.jobs.pop_back();
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        static void record(std::array<std::atomic_size_t, BlockingLaneMetrics::BUCKET_COUNT>& histogram, Clock::duration time) {
+            auto& bounds = BlockingLaneMetrics::BUCKET_BOUNDS;
+            auto bucket = std::upper_bound(bounds.begin(), bounds.end(), time) - bounds.begin();
+            histogram[bucket].fetch_add(1, std::memory_order::relaxed);
+        }
+
+        void run(size_t index) {
+            while (true) {
+                BlockingJob job;
+                if (!this->take(index, job)) {
+                    std::unique_lock lock(m_sleepMutex);
+                    m_sleepCV.wait(lock, [this] {
+                        return m_queued.load(std::memory_order::acquire) > 0 || m_stopping.load(std::memory_order::acquire);
+                    });
+                    // finish the remaining jobs before stopping
+                    if (m_stopping.load(std::memory_order::acquire) && m_queued.load(std::memory_order::acquire) == 0) {
+                        return;
+                    }
+                    continue;
+                }
+
+                m_queued.fetch_sub(1, std::memory_order::relaxed);
+                m_active.fetch_add(1, std::memory_order::relaxed);
+                auto start = Clock::now();
+                record(m_waitHistogram, start - job.queuedAt);
+
+                try {
+                    job.func();
+                }
+                catch (std::exception const& e) {
+                    utils::terminate(fmt::format(
+                        "{} lane terminated due to unhandled exception: {}",
+                        m_name, e.what()
+                    ));
+                }
+                job.func = nullptr;
+
+                record(m_runHistogram, Clock::now() - start);
+                m_active.fetch_sub(1, std::memory_order::relaxed);
+                m_completed.fetch_add(1, std::memory_order::relaxed);
+            }
+        }
+    };
+
+    BlockingPool& blockingPool(BlockingLane lane) {
+        static auto cores = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+        // leaked on purpose, jobs may still be spawned while static destructors run
+        static auto io = new BlockingPool("IO", std::clamp<size_t>(cores / 2, 2, 4));
+        static auto cpu = new BlockingPool("CPU", cores);
+        return lane == BlockingLane::IO ? *io : *cpu;
+    }
+}
+
+void spawnBlocking(BlockingLane lane, Function<void()> func) {
+    blockingPool(lane).spawn(std::move(func));
+}
+
+BlockingLaneMetrics getBlockingLaneMetrics(BlockingLane lane) {
+    return blockingPool(lane).getMetrics();
+}
+
+void queueInMainThreadAfter(std::chrono::milliseconds delay, Function<void()> func) {
+    // the runtime is gone while the game exits, there is no next frame to wait for then
+    if (!runtimePtr()) {
+        geode::queueInMainThread(std::move(func));
+        return;
+    }
+    async::spawn([delay, func = std::move(func)] mutable -> arc::Future<> {
+        co_await arc::sleepUntil(asp::Instant::now() + asp::Duration::fromMillis(delay.count()));
+        geode::queueInMainThread(std::move(func));
+    });
+}
+
 }
 
 $on_mod(Loaded) {
@@ -42,6 +239,8 @@ $on_mod(Loaded) {
         log::Logger::get()->shutdownThread();
         async::runtime().safeShutdown();
         async::runtimePtr().reset();
+        async::blockingPool(async::BlockingLane::IO).shutdown();
+        async::blockingPool(async::BlockingLane::CPU).shutdown();
         log::debug("Shutdown complete.");
     }, 100).leak();
 }
@@ -0,0 +1,84 @@
+#include "cache.hpp"
+#include <Geode/loader/Dirs.hpp>
+#include <Geode/utils/file.hpp>
+
+using namespace geode::prelude;
+
+namespace {
+    // bump whenever the layout of any cache changes
+    constexpr uint32_t CACHE_VERSION = 2;
+
+    struct Header {
+        uint32_t magic;
+        uint32_t version;
+        cache::Stamp stamp;
+        Sha256 source;
+    };
+}
+
+std::optional<cache::Stamp> cache::stampOf(std::filesystem::path const& path) {
+    std::error_code ec;
+    auto size = std::filesystem::file_size(path, ec);
+    if (ec) return std::nullopt;
+    auto time = std::filesystem::last_write_time(path, ec);
+    if (ec) return std::nullopt;
+    return Stamp {
+        .size = static_cast<uint64_t>(size),
+        .modifiedAt = static_cast<int64_t>(time.time_since_epoch().count()),
+    };
+}
+
+std::filesystem::path cache::pathFor(std::string_view source, std::string_view extension) {
+    auto name = sha256(source).toString();
+    name.resize(32);
+    name += extension;
+    return dirs::getModRuntimeDir() / "cache" / name;
+}
+
+std::optional<ByteVector> cache::read(
+    std::filesystem::path const& path, uint32_t magic,
+    std::optional<Stamp> const& stamp, FunctionRef<std::optional<Sha256>()> hashSource
+) {
+    auto res = file::readBinary(path);
+    if (!res) return std::nullopt;
+    auto data = std::move(res).unwrap();
+
+    Header header;
+    Reader reader(data);
+    if (!reader.read(header) || header.magic != magic || header.version != CACHE_VERSION) {
+        return std::nullopt;
+    }
+
+    if (!stamp || header.stamp != *stamp) {
+        auto hash = hashSource();
+        if (!hash || header.source != *hash) {
+            return std::nullopt;
+        }
+        // the source was only touched, so remember the new stamp for next time
+        if (stamp) {
+            header.stamp = *stamp;
+            std::memcpy(data.data(), &header, sizeof(Header));
+            (void)file::writeBinarySafe(path, data);
+        }
+    }
+
+    data.erase(data.begin(), data.begin() + sizeof(Header));
+    return data;
+}
+
+Result<> cache::write(
+    std::filesystem::path const& path, uint32_t magic,
+    std::optional<Stamp> const& stamp, Sha256 const& source, ByteSpan body
+) {
+    GEODE_UNWRAP(file::createDirectoryAll(path.parent_path()));
+
+    Writer writer;
+    writer.write(Header {
+        .magic = magic,
+        .version = CACHE_VERSION,
+        .stamp = stamp.value_or(Stamp {}),
+        .source = source,
+    });
+    writer.data().insert(writer.data().end(), body.begin(), body.end());
+    return file::writeBinarySafe(path, writer.data());
+}
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <Geode/Result.hpp>
+#include <Geode/utils/function.hpp>
+#include <Geode/utils/general.hpp>
+#include <Geode/utils/hash.hpp>
+#include <cstring>
+#include <filesystem>
+#include <optional>
+#include <string_view>
+#include <type_traits>
+
+// Binary caches of parsed resource files. Each cache file starts with a magic,
+// a format version and the size, modification time and SHA256 of the file it
+// was made from. The size and time are checked first so an unchanged source is
+// never read, the hash only decides whether a touched source really changed.
+// Values are written in native byte order, as the caches never leave the
+// machine that made them
+namespace geode::cache {
+    struct Stamp {
+        uint64_t size = 0;
+        int64_t modifiedAt = 0;
+
+        bool operator==(Stamp const&) const = default;
+    };
+
+    // Size and modification time of a file on disk, if it is on disk at all
+    std::optional<Stamp> stampOf(std::filesystem::path const& path);
+
+    class Writer final {
+        ByteVector m_data;
+
+    public:
+        template <class T> requires std::is_trivially_copyable_v<T>
+        void write(T const& value) {
+            auto bytes = reinterpret_cast<uint8_t const*>(&value);
+            m_data.insert(m_data.end(), bytes, bytes + sizeof(T));
+        }
+        void writeString(std::string_view str) {
+            this->write(static_cast<uint32_t>(str.size()));
+            m_data.insert(m_data.end(), str.begin(), str.end());
+        }
+
+        ByteVector& data() {
+            return m_data;
+        }
+    };
+
+    // Reads values straight out of the cache buffer, strings are views into it
+    class Reader final {
+        ByteSpan m_data;
+        size_t m_offset = 0;
+
+    public:
+        Reader(ByteSpan data) : m_data(data) {}
+
+        template <class T> requires std::is_trivially_copyable_v<T>
+        bool read(T& out) {
+            if (m_data.size() - m_offset < sizeof(T)) return false;
+            std::memcpy(&out, m_data.data() + m_offset, sizeof(T));
+            m_offset += sizeof(T);
+            return true;
+        }
+        bool readString(std::string_view& out) {
+            uint32_t size;
+            if (!this->read(size) || m_data.size() - m_offset < size) return false;
+            out = std::string_view(reinterpret_cast<char const*>(m_data.data() + m_offset), size);
+            m_offset += size;
+            return true;
+        }
+
+        bool done() const {
+            return m_offset == m_data.size();
+        }
+    };
+
+    // Where the cache for the given source file (by its full path) is stored
+    std::filesystem::path pathFor(std::string_view source, std::string_view extension);
+
+    // Returns the body of the cache if it exists and was made from the given source.
+    // The source is only hashed (through hashSource) when its stamp does not match
+    // or is unknown; if the hash still matches, the cache is restamped and kept
+    std::optional<ByteVector> read(
+        std::filesystem::path const& path, uint32_t magic,
+        std::optional<Stamp> const& stamp, FunctionRef<std::optional<Sha256>()> hashSource
+    );
+    Result<> write(
+        std::filesystem::path const& path, uint32_t magic,
+        std::optional<Stamp> const& stamp, Sha256 const& source, ByteSpan body
+    );
+}
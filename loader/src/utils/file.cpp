@@ -337,6 +337,7 @@ struct ZipEntry {
     bool isDirectory;
     int64_t compressedSize;
     int64_t uncompressedSize;
+    uint32_t crc32;
 };
 
 class Zip::Impl final {
@@ -426,6 +427,7 @@ private:
                 .isDirectory = mz_zip_entry_is_dir(m_handle) == MZ_OK,
                 .compressedSize = info->compressed_size,
                 .uncompressedSize = info->uncompressed_size,
+                .crc32 = info->crc,
             } });
 
             err = mz_zip_goto_next_entry(m_handle);
@@ -504,7 +506,7 @@ public:
         return Ok();
     }
 
-    Result<> extractAllTo(Path const& dir) {
+    Result<> extractAllTo(Path const& dir, geode::Function<bool(Path const&)> filter = nullptr) {
         GEODE_UNWRAP(file::createDirectoryAll(dir));
 
         GEODE_UNWRAP(
@@ -535,6 +537,10 @@ public:
             Path filePath;
             filePath.assign(info->filename, info->filename + info->filename_size);
 
+            if (filter && !filter(filePath)) {
+                continue;
+            }
+
             // make sure zip files like root/../../file.txt don't get extracted to
             // avoid zip attacks
             std::error_code ec;
@@ -699,6 +705,11 @@ public:
         return m_entries;
     }
 
+    ZipEntry const* getEntry(Path const& name) const {
+        auto it = m_entries.find(name);
+        return it != m_entries.end() ? &it->second : nullptr;
+    }
+
     ~Impl() {
         if (m_handle) {
             mz_zip_close(m_handle);
@@ -747,6 +758,18 @@ bool Unzip::hasEntry(Path const& name) {
     return m_impl->getEntries().count(name);
 }
 
+std::optional<Unzip::EntryInfo> Unzip::getEntryInfo(Path const& name) const {
+    auto entry = m_impl->getEntry(name);
+    if (!entry) {
+        return std::nullopt;
+    }
+    return EntryInfo {
+        .isDirectory = entry->isDirectory,
+        .crc32 = entry->crc32,
+        .size = static_cast<uint64_t>(entry->uncompressedSize),
+    };
+}
+
 Result<ByteVector> Unzip::extract(Path const& name) {
     return m_impl->extract(name).mapErr([&](auto error) {
         return fmt::format("Unable to extract entry {}: {}", name, error);
@@ -771,6 +794,10 @@ Result<> Unzip::extractAllTo(Path const& dir) {
     return m_impl->extractAllTo(dir);
 }
 
+Result<> Unzip::extractAllTo(Path const& dir, geode::Function<bool(Path const&)> filter) {
+    return m_impl->extractAllTo(dir, std::move(filter));
+}
+
 Result<> Unzip::intoDir(
     Path const& from,
     Path const& to,
@@ -0,0 +1,124 @@
+#include <Geode/utils/trace.hpp>
+#include <Geode/loader/Mod.hpp>
+#include <Geode/utils/file.hpp>
+#include <Geode/utils/general.hpp>
+#include <atomic>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+#include "trace.hpp"
+
+using namespace geode::prelude;
+
+namespace {
+    struct RecordedSpan {
+        std::string name;
+        Mod* mod;
+        uint32_t thread;
+        trace::Clock::time_point begin;
+        trace::Clock::time_point end;
+    };
+
+    struct Recorder {
+        std::atomic_bool enabled = false;
+        trace::Clock::time_point origin;
+        std::atomic_uint32_t nextThread = 0;
+
+        std::mutex mutex;
+        std::vector<RecordedSpan> spans;
+        std::unordered_map<uint32_t, std::string> threadNames;
+    };
+
+    Recorder& recorder() {
+        // leaked so that spans recorded during static destruction don't crash
+        static auto recorder = new Recorder();
+        return *recorder;
+    }
+
+    uint32_t currentThread() {
+        static thread_local uint32_t id = recorder().nextThread.fetch_add(1, std::memory_order::relaxed);
+        return id;
+    }
+}
+
+bool trace::isEnabled() {
+    return recorder().enabled.load(std::memory_order::relaxed);
+}
+
+void trace::addSpan(std::string_view name, Mod* mod, Clock::time_point begin, Clock::time_point end) {
+    auto& rec = recorder();
+    if (!rec.enabled.load(std::memory_order::relaxed)) return;
+
+    auto thread = currentThread();
+    auto threadName = utils::thread::getName().view();
+
+    std::lock_guard lock(rec.mutex);
+    rec.spans.push_back(RecordedSpan {
+        .name = std::string(name),
+        .mod = mod,
+        .thread = thread,
+        .begin = begin,
+        .end = end,
+    });
+    // threads get renamed, the last name is the most useful one
+    auto it = rec.threadNames.find(thread);
+    if (it == rec.threadNames.end()) {
+        rec.threadNames.emplace(thread, std::string(threadName));
+    }
+    else if (it->second != threadName) {
+        it->second = threadName;
+    }
+}
+
+void trace::enable() {
+    auto& rec = recorder();
+    rec.origin = Clock::now();
+    rec.enabled.store(true, std::memory_order::release);
+}
+
+Result<> trace::exportTo(std::filesystem::path const& path) {
+    auto& rec = recorder();
+    rec.enabled.store(false, std::memory_order::relaxed);
+
+    std::vector<RecordedSpan> spans;
+    std::unordered_map<uint32_t, std::string> threadNames;
+    {
+        std::lock_guard lock(rec.mutex);
+        spans = std::move(rec.spans);
+        threadNames = std::move(rec.threadNames);
+    }
+
+    auto micros = [&](Clock::duration duration) {
+        return std::chrono::duration_cast<std::chrono::duration<double, std::micro>>(duration).count();
+    };
+
+    auto events = matjson::Value::array();
+    for (auto const& [thread, name] : threadNames) {
+        events.push(matjson::makeObject({
+            { "name", "thread_name" },
+            { "ph", "M" },
+            { "pid", 1 },
+            { "tid", thread },
+            { "args", matjson::makeObject({ { "name", name } }) },
+        }));
+    }
+    for (auto const& span : spans) {
+        auto modID = span.mod ? span.mod->getID() : "geode.loader";
+        events.push(matjson::makeObject({
+            { "name", span.name },
+            { "cat", modID },
+            { "ph", "X" },
+            { "ts", micros(span.begin - rec.origin) },
+            { "dur", micros(span.end - span.begin) },
+            { "pid", 1 },
+            { "tid", span.thread },
+            { "args", matjson::makeObject({ { "mod", modID } }) },
+        }));
+    }
+
+    auto json = matjson::makeObject({
+        { "traceEvents", events },
+        { "displayTimeUnit", "ms" },
+    });
+    return file::writeStringSafe(path, json.dump(matjson::NO_INDENTATION));
+}
@@ -0,0 +1,10 @@
+#pragma once
+
+#include <Geode/Result.hpp>
+#include <filesystem>
+
+namespace geode::trace {
+    // only the loader decides when recording starts and where it ends up
+    void enable();
+    Result<> exportTo(std::filesystem::path const& path);
+}
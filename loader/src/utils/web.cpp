@@ -431,6 +431,7 @@ public:
         size_t id;
         WebResponse response;
         geode::Function<void(WebResponse)> onComplete;
+        async::ProgressSlot<WebProgress> progress;
         CURL* curl = nullptr;
 
         RequestData(std::shared_ptr<WebRequest::Impl> req, Mod* mod, size_t id, geode::Function<void(WebResponse)> cb)
@@ -491,6 +492,7 @@ public:
     std::optional<asp::Duration> m_timeout;
     std::optional<std::pair<std::uint64_t, std::uint64_t>> m_range;
     std::vector<geode::Function<void(WebProgress const&)>> m_progressCallbacks;
+    std::chrono::milliseconds m_progressInterval{0};
     std::string m_CABundleContent;
     std::optional<DnsServer> m_dnsServer;
     bool m_bypassDnsCache = false;
@@ -509,7 +511,6 @@ public:
     std::atomic<size_t> m_downloadTotal = 0;
     std::atomic<size_t> m_uploadCurrent = 0;
     std::atomic<size_t> m_uploadTotal = 0;
-    std::atomic<bool> m_progressNotifQueued{false};
     std::atomic<bool> m_cancelled{false};
 
     // stored to clean up later
@@ -840,6 +841,15 @@ public:
 
         // Track & post progress on the Promise
         // onProgress can only be not set if using sendSync without one, and hasBeenCancelled is always null in that case
+        if (!m_progressCallbacks.empty()) {
+            requestData->progress = async::ProgressSlot<WebProgress>([req = requestData->request](WebProgress progress) {
+                if (req->m_cancelled.load(std::memory_order::relaxed)) return;
+
+                for (auto& callback : req->m_progressCallbacks) {
+                    callback(progress);
+                }
+            }, m_progressInterval);
+        }
         curl_easy_setopt(curl, CURLOPT_XFERINFODATA, requestData);
         curl_easy_setopt(curl, CURLOPT_XFERINFOFUNCTION, +[](void* ptr, curl_off_t dtotal, curl_off_t dnow, curl_off_t utotal, curl_off_t unow) -> int {
             auto data = static_cast<ResponseData*>(ptr);
@@ -853,16 +863,9 @@ public:
             r.m_uploadTotal.store(static_cast<size_t>(utotal), relaxed);
             r.m_uploadCurrent.store(static_cast<size_t>(unow), relaxed);
 
-            // Queue the callback in the main thread, make sure to do it only once per frame
-            if (!r.m_progressCallbacks.empty() && !r.m_progressNotifQueued.exchange(true, acq_rel) && !r.m_cancelled.load(relaxed)) {
-                queueInMainThread([req = data->request] {
-                    if (req->m_cancelled.load(relaxed)) return;
-                    req->m_progressNotifQueued.store(false, release);
-
-                    for (auto& callback : req->m_progressCallbacks) {
-                        callback(req->progress());
-                    }
-                });
+            // The slot coalesces these into at most one callback per frame
+            if (data->progress && !r.m_cancelled.load(relaxed)) {
+                data->progress.post(r.progress());
             }
 
             // Continue as normal
@@ -1078,6 +1081,11 @@ WebRequest& WebRequest::bodyMultipart(MultipartForm const& form) {
     return *this;
 }
 
+WebRequest& WebRequest::progressInterval(std::chrono::milliseconds interval) {
+    m_impl->m_progressInterval = interval;
+    return *this;
+}
+
 WebRequest& WebRequest::onProgress(Function<void(WebProgress const&)> callback) {
     m_impl->m_progressCallbacks.emplace_back(std::move(callback));
     return *this;
@@ -2,6 +2,7 @@
 #include <Geode/loader/ModEvent.hpp>
 #include <Geode/utils/cocos.hpp>
 #include <chrono>
+#include <thread>
 #include "../dependency/main.hpp"
 #include "Geode/utils/general.hpp"
 #include <Geode/utils/VMTHookManager.hpp>
@@ -61,6 +62,449 @@ $on_mod(Loaded) {
     geode::log::info("Value after dispatch: {}", value);
 }
 
+// Removing receivers while sending
+struct TestRemovalEvent : Event<TestRemovalEvent, bool(int)> {
+    using Event::Event;
+    using Event::removeReceiver;
+};
+$on_mod(Loaded) {
+    std::vector<int> calls;
+    size_t countDuringSend = 0;
+    ListenerHandle second;
+    auto first = TestRemovalEvent().listen([&](int) {
+        calls.push_back(1);
+        // removing the same receiver twice, and the handle removed receivers are
+        // marked with, must not touch any other receiver
+        auto copy = second.downgrade();
+        second.destroy();
+        copy.destroy();
+        TestRemovalEvent().removeReceiver(comm::ReceiverHandle());
+        countDuringSend = TestRemovalEvent().getReceiverCount();
+        return false;
+    });
+    second = TestRemovalEvent().listen([&](int) {
+        calls.push_back(2);
+        return false;
+    });
+    auto third = TestRemovalEvent().listen([&](int) {
+        calls.push_back(3);
+        return false;
+    });
+    TestRemovalEvent().send(0);
+    TestRemovalEvent().send(0);
+    if (calls != std::vector{ 1, 3, 1, 3 } || TestRemovalEvent().getReceiverCount() != 2 || countDuringSend != 2) {
+        log::error("Removing receivers during a send removed the wrong ones");
+    }
+}
+
+// Thread safe events under contention
+$on_mod(Loaded) {
+    std::atomic_size_t received = 0;
+    auto handle = Dispatch<int>("geode.test/contention").listen([&](int) {
+        received.fetch_add(1, std::memory_order_relaxed);
+    });
+
+    // receivers come and go on every thread while the others send
+    constexpr size_t perThread = 5000;
+    auto threadCount = std::max(std::thread::hardware_concurrency(), 2u);
+    std::vector<std::thread> threads;
+    for (unsigned i = 0; i < threadCount; ++i) {
+        threads.emplace_back([] {
+            for (size_t j = 0; j < perThread; ++j) {
+                Dispatch<int>("geode.test/contention").send(static_cast<int>(j));
+                if (j % 100 == 0) {
+                    auto temp = Dispatch<int>("geode.test/contention").listen([](int) {});
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    if (received != perThread * threadCount) {
+        log::error("{} threads sent {} events, but {} were received", threadCount, perThread * threadCount, received.load());
+    }
+}
+
+// Once and coalesced events
+struct TestReadyEvent : OnceEvent<TestReadyEvent, bool(std::string const&)> {
+    using OnceEvent::OnceEvent;
+};
+struct TestProgressEvent : ThreadSafeCoalescedEvent<TestProgressEvent, bool(float)> {
+    using ThreadSafeCoalescedEvent::ThreadSafeCoalescedEvent;
+};
+$on_mod(Loaded) {
+    TestReadyEvent().send("ready");
+    TestReadyEvent().listen([](std::string const& str) {
+        log::info("Late listener received once event: {}", str);
+    }).leak();
+
+    TestProgressEvent().listen([](float progress) {
+        log::info("Coalesced progress: {}", progress);
+    }).leak();
+    std::thread([] {
+        for (int i = 0; i <= 100; ++i) {
+            TestProgressEvent().send(i / 100.f);
+        }
+    }).detach();
+}
+
+// Node events through the script engine, whose channels have to outlive
+// a listener that removes the last receiver of the node while it is called
+#include <Geode/loader/GameEvent.hpp>
+#include <Geode/ui/NodeEvent.hpp>
+$on_game(Loaded) {
+    auto node = Ref(CCNode::create());
+    auto engine = CCScriptEngineManager::sharedManager()->getScriptEngine();
+    auto send = [&](NodeEventType type) {
+        engine->executeNodeEvent(node, static_cast<int>(type));
+    };
+
+    int entered = 0;
+    ListenerHandle handle;
+    handle = NodeEvent(node.data(), NodeEventType::OnEnter).listen([&] {
+        entered += 1;
+        handle.destroy();
+    });
+    send(NodeEventType::OnEnter);
+    send(NodeEventType::OnEnter);
+    if (entered != 1) {
+        log::error("Node event listener that removed itself was called {} times", entered);
+    }
+
+    // the channel is made again for a later listener
+    int exited = 0;
+    auto exitHandle = NodeEvent(node.data(), NodeEventType::OnExit).listen([&] {
+        exited += 1;
+    });
+    send(NodeEventType::OnExit);
+    send(NodeEventType::OnEnter);
+    if (exited != 1 || entered != 1) {
+        log::error("Node events went to the wrong listeners ({} exits, {} enters)", exited, entered);
+    }
+}
+
+// Nodes with the fields of several modifies
+#include <Geode/modify/CCNode.hpp>
+template <int N>
+struct FieldTest : Modify<FieldTest<N>, CCNode> {
+    struct Fields {
+        int value = N;
+        std::string name = fmt::format("fields-{}", N);
+    };
+};
+template struct FieldTest<0>;
+template struct FieldTest<1>;
+template struct FieldTest<2>;
+
+$on_game(Loaded) {
+    // fields made before the node got its metadata have to keep the user
+    // object that was there, and every modify gets its own fields
+    auto object = CCNode::create();
+    auto node = Ref(CCNode::create());
+    node->setUserObject(object);
+
+    static_cast<FieldTest<1>*>(node.data())->m_fields->value = 10;
+    static_cast<FieldTest<2>*>(node.data())->m_fields->name = "changed";
+    auto first = static_cast<FieldTest<0>*>(node.data())->m_fields.self();
+    auto second = static_cast<FieldTest<1>*>(node.data())->m_fields.self();
+    auto third = static_cast<FieldTest<2>*>(node.data())->m_fields.self();
+    if (
+        first->value != 0 || first->name != "fields-0" ||
+        second->value != 10 || second->name != "fields-1" ||
+        third->value != 2 || third->name != "changed"
+    ) {
+        log::error("Fields of different modifies are mixed up");
+    }
+    if (static_cast<FieldTest<0>*>(node.data())->m_fields.self() != first) {
+        log::error("Fields moved between two accesses");
+    }
+    if (node->getUserObject() != object) {
+        log::error("Fields replaced the user object of the node");
+    }
+
+    auto fresh = Ref(CCNode::create());
+    if (static_cast<FieldTest<1>*>(fresh.data())->m_fields->value != 1) {
+        log::error("Fields of a new node did not start from their defaults");
+    }
+}
+
+// ID lookups, with and without an index
+#include <Geode/utils/coro.hpp>
+$on_game(Loaded) {
+    // every menu has the same button IDs, so the order of the matches matters
+    auto root = Ref(CCNode::create());
+    for (int i = 0; i < 5; ++i) {
+        auto layer = CCNode::create();
+        layer->setID(fmt::format("layer-{}", i));
+        for (int j = 0; j < 4; ++j) {
+            auto menu = CCNode::create();
+            menu->setID(fmt::format("menu-{}", j));
+            for (int k = 0; k < 10; ++k) {
+                auto button = CCNode::create();
+                button->setID(fmt::format("button-{}", k));
+                menu->addChild(button);
+            }
+            layer->addChild(menu);
+        }
+        root->addChild(layer);
+    }
+
+    struct Results {
+        CCNode* recursive;
+        CCNode* selected;
+        std::vector<CCNode*> all;
+
+        bool operator==(Results const&) const = default;
+    };
+    auto lookup = [&](std::string_view id, std::string_view query) {
+        Results results { root->getChildByIDRecursive(id), root->querySelector(query) };
+        for (auto node : root->querySelectorAll(query)) {
+            results.all.push_back(node);
+        }
+        // querySelectorAll makes no promise about the order with an index
+        std::sort(results.all.begin(), results.all.end());
+        return results;
+    };
+
+    auto plain = lookup("button-9", "layer-3 menu-2 > button-9");
+    if (!plain.recursive || plain.recursive->getParent()->getID() != "menu-0" || plain.all.size() != 1) {
+        log::error("ID lookups found the wrong nodes");
+    }
+    auto plainMenus = lookup("menu-1", "menu-1");
+
+    root->setIDIndexEnabled();
+    if (lookup("button-9", "layer-3 menu-2 > button-9") != plain || lookup("menu-1", "menu-1") != plainMenus) {
+        log::error("ID lookups through the index differ from the ones without it");
+    }
+
+    // the index follows the tree
+    auto menu = root->getChildByIDRecursive("layer-4")->getChildByID("menu-3");
+    auto added = CCNode::create();
+    added->setID("added");
+    menu->addChild(added);
+    if (root->getChildByIDRecursive("added") != added || root->querySelector("layer-4 menu-3 > added") != added) {
+        log::error("Index did not pick up an added node");
+    }
+    added->setID("renamed");
+    if (root->getChildByIDRecursive("added") || root->getChildByIDRecursive("renamed") != added) {
+        log::error("Index did not pick up a changed ID");
+    }
+    added->removeFromParent();
+    if (root->getChildByIDRecursive("renamed")) {
+        log::error("Index still finds a removed node");
+    }
+
+    // a subtree taken out of the index is searched like any other
+    auto layer = Ref(root->getChildByID("layer-0"));
+    layer->removeFromParent();
+    if (layer->getChildByIDRecursive("button-9") != plain.recursive) {
+        log::error("Lookups in a subtree removed from an index failed");
+    }
+    if (root->getChildByIDRecursive("button-9") == plain.recursive) {
+        log::error("Index still finds nodes of a removed subtree");
+    }
+}
+
+// Main thread lanes run in priority order, each in the order it was pushed to
+$on_game(Loaded) {
+    // the background lane runs last, so everything pushed from it waits for the next frame
+    queueInMainThread([] {
+        auto order = std::make_shared<std::vector<int>>();
+        queueInMainThread([order] {
+            order->push_back(4);
+            if (*order != std::vector{ 0, 1, 2, 3, 4 }) {
+                log::error("Main thread lanes ran out of order");
+            }
+        }, MainThreadPriority::Background);
+        for (int i = 1; i <= 3; ++i) {
+            queueInMainThread([order, i] { order->push_back(i); }, MainThreadPriority::UI);
+        }
+        queueInMainThread([order] { order->push_back(0); }, MainThreadPriority::InputCritical);
+    }, MainThreadPriority::Background);
+}
+
+// Main thread queue under contention keeps the order of every thread
+$on_game(Loaded) {
+    constexpr size_t perThread = 2000;
+    auto threadCount = std::max(std::thread::hardware_concurrency(), 2u);
+    struct State {
+        std::vector<size_t> next;
+        bool failed = false;
+    };
+    auto state = std::make_shared<State>();
+    state->next.resize(threadCount);
+
+    for (unsigned i = 0; i < threadCount; ++i) {
+        std::thread([state, i] {
+            for (size_t j = 0; j < perThread; ++j) {
+                queueInMainThread([state, i, j] {
+                    // only ever touched on the main thread
+                    if (state->next[i] != j && !state->failed) {
+                        state->failed = true;
+                        log::error("Main thread queue ran function {} of thread {} out of order", j, i);
+                    }
+                    state->next[i] = j + 1;
+                });
+            }
+        }).detach();
+    }
+}
+
+// Bitmap font caches are dropped when their font changes
+#include <Geode/ui/Label.hpp>
+#include <Geode/utils/file.hpp>
+$on_game(Loaded) {
+    auto path = Mod::get()->getSaveDir() / "test-font.fnt";
+    auto pathStr = utils::string::pathToString(path);
+    auto writeFont = [&](int amount) {
+        return file::writeString(path, fmt::format(
+            "info face=\"Test\" size=32 padding=0,0,0,0\n"
+            "common lineHeight=32 base=26 scaleW=256 scaleH=256 pages=1\n"
+            "page id=0 file=\"test-font.png\"\n"
+            "chars count=1\n"
+            "char id=65 x=0 y=0 width=16 height=16 xoffset=0 yoffset=0 xadvance=16 page=0\n"
+            "kernings count=1\n"
+            "kerning first=65 second=65 amount={}\n",
+            amount
+        ));
+    };
+    auto kerningOf = [&]() -> std::optional<float> {
+        BitmapFont::purgeFont(pathStr);
+        auto font = BitmapFont::load(pathStr);
+        if (!font) return std::nullopt;
+        auto it = font->getKernings().find({ 65, 65 });
+        if (it == font->getKernings().end()) return std::nullopt;
+        auto scale = CCDirector::get()->getContentScaleFactor();
+        if (std::abs(it->second.scaled * scale - it->second.amount) > 0.001f) return std::nullopt;
+        return it->second.amount;
+    };
+
+    if (!writeFont(-2)) {
+        log::error("Unable to write the test font");
+        return;
+    }
+    // the second load comes from the cache made by the first
+    auto parsed = kerningOf();
+    auto cached = kerningOf();
+    if (parsed != -2.f || cached != -2.f) {
+        log::error("Font kerning did not survive the cache");
+    }
+
+    (void)writeFont(-13);
+    if (kerningOf() != -13.f) {
+        log::error("Font cache was not dropped when the font changed");
+    }
+    BitmapFont::purgeFont(pathStr);
+}
+
+// Main thread lanes and frame budget
+$on_game(Loaded) {
+    for (int i = 0; i < 200; ++i) {
+        queueInMainThread([first = i == 0] {
+            if (first) {
+                // input critical work runs first, so this lands at the start of the
+                // next frame, after one frame of background work has run
+                queueInMainThread([] {
+                    auto metrics = Loader::get()->getMainThreadLaneMetrics(MainThreadPriority::Background);
+                    log::info(
+                        "Background lane after one frame: {} waiting, {} ran, latency avg {}us, max {}us",
+                        metrics.queueDepth, metrics.executedLastFrame,
+                        metrics.averageLatency.count(), metrics.maxLatency.count()
+                    );
+                    if (metrics.executedLastFrame == 0 || metrics.queueDepth >= 200) {
+                        log::error("Background lane did not run during the last frame");
+                    }
+                }, MainThreadPriority::InputCritical);
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }, MainThreadPriority::Background);
+    }
+}
+
+// Main thread lanes reuse their nodes for a thread that pushes to all of them
+$on_game(Loaded) {
+    std::thread([] {
+        constexpr std::array lanes = {
+            MainThreadPriority::InputCritical, MainThreadPriority::UI, MainThreadPriority::Background
+        };
+        constexpr size_t rounds = 10, perLane = 100;
+        std::array<size_t, lanes.size()> before;
+        for (size_t i = 0; i < lanes.size(); ++i) {
+            before[i] = Loader::get()->getMainThreadLaneMetrics(lanes[i]).allocatedNodes;
+        }
+        for (size_t round = 0; round < rounds; ++round) {
+            auto remaining = std::make_shared<std::atomic_size_t>(perLane * lanes.size());
+            for (auto lane : lanes) {
+                for (size_t i = 0; i < perLane; ++i) {
+                    queueInMainThread([remaining] { remaining->fetch_sub(1); }, lane);
+                }
+            }
+            while (remaining->load() != 0) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+        }
+        for (size_t i = 0; i < lanes.size(); ++i) {
+            // other threads push too, but without reuse this thread alone would
+            // allocate a node for every function
+            auto allocated = Loader::get()->getMainThreadLaneMetrics(lanes[i]).allocatedNodes - before[i];
+            if (allocated >= rounds * perLane / 2) {
+                log::error("Main thread lane {} allocated {} nodes for {} functions", i, allocated, rounds * perLane);
+            }
+        }
+    }).detach();
+}
+
+// Hook batches
+static uint8_t s_batchBytes[8] = { 1, 2, 3, 4, 5, 6, 7, 8 };
+
+$on_game(Loaded) {
+    auto makePatch = [](size_t offset, ByteVector bytes) -> Patch* {
+        auto patch = Patch::create(s_batchBytes + offset, bytes);
+        patch->setAutoEnable(false);
+        return Mod::get()->claimPatch(std::move(patch)).unwrapOr(nullptr);
+    };
+    auto first = makePatch(0, { 0xaa, 0xaa });
+    auto second = makePatch(4, { 0xbb, 0xbb });
+    // overlaps the first one, so it can never be enabled alongside it
+    auto overlapping = makePatch(1, { 0xcc });
+    auto hooks = Mod::get()->getHooks();
+    auto hook = hooks.empty() ? nullptr : hooks.front();
+    if (!first || !second || !overlapping || !hook || !hook->isEnabled()) {
+        log::error("Hook batch test could not be set up");
+        return;
+    }
+
+    auto res = HookBatch().enable(first).enable(second).commit();
+    if (!res || !first->isEnabled() || !second->isEnabled() || s_batchBytes[0] != 0xaa || s_batchBytes[5] != 0xbb) {
+        log::error("Hook batch did not apply its patches: {}", res.err().value_or("bytes differ"));
+    }
+
+    // this one fails as a whole, so the hook has to stay enabled
+    res = HookBatch().disable(hook).disable(second).enable(overlapping).commit();
+    if (res || !hook->isEnabled() || !second->isEnabled() || s_batchBytes[1] != 0xaa) {
+        log::error("Failed hook batch was not rolled back");
+    }
+
+    res = HookBatch().disable(first).disable(second).commit();
+    if (!res || first->isEnabled() || second->isEnabled() || s_batchBytes[0] != 1 || s_batchBytes[5] != 6) {
+        log::error("Hook batch did not restore the original bytes: {}", res.err().value_or("bytes differ"));
+    }
+    else {
+        log::info("Hook batch committed and rolled back");
+    }
+
+    // the last request wins, even if it is the state things are already in
+    res = HookBatch().enable(first).disable(first).disable(hook).enable(hook).commit();
+    if (!res || first->isEnabled() || s_batchBytes[0] != 1 || !hook->isEnabled()) {
+        log::error("Hook batch did not apply the last request for each patch and hook");
+    }
+
+    for (auto patch : { first, second, overlapping }) {
+        (void)Mod::get()->disownPatch(patch);
+    }
+}
+
 static std::string s_receivedEvent;
 
 // Events